@@ -7,10 +7,13 @@
 
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <nfx/string/StringBuilderPool.h>
 
+#include "BenchmarkCounters.h"
+
 namespace nfx::string::benchmark
 {
 	//=====================================================================
@@ -45,6 +48,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StdString_SmallStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::string result;
@@ -60,6 +65,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringStream_SmallStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::ostringstream oss;
@@ -76,6 +83,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringBuilderPool_SmallStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			auto lease = StringBuilderPool::lease();
@@ -97,6 +106,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StdString_MediumStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::string result;
@@ -113,6 +124,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringStream_MediumStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::ostringstream oss;
@@ -129,6 +142,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringBuilderPool_MediumStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			auto lease = StringBuilderPool::lease();
@@ -150,6 +165,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StdString_LargeStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::string result;
@@ -166,6 +183,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringStream_LargeStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::ostringstream oss;
@@ -182,6 +201,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringBuilderPool_LargeStrings( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			auto lease = StringBuilderPool::lease();
@@ -204,6 +225,8 @@ namespace nfx::string::benchmark
 	static void BM_StdString_RapidCycles( ::benchmark::State& state )
 	{
 		// Equivalent rapid string building without pooling
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			for ( int i = 0; i < 10; ++i )
@@ -220,6 +243,8 @@ namespace nfx::string::benchmark
 	static void BM_StringBuilderPool_PoolEfficiency( ::benchmark::State& state )
 	{
 		// Test pool efficiency with rapid lease/return cycles
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			for ( int i = 0; i < 10; ++i )
@@ -239,6 +264,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StdString_MixedOperations( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::string result = "Header: ";
@@ -263,6 +290,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringStream_MixedOperations( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			std::ostringstream oss;
@@ -284,6 +313,8 @@ namespace nfx::string::benchmark
 
 	static void BM_StringBuilderPool_MixedOperations( ::benchmark::State& state )
 	{
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			auto lease = StringBuilderPool::lease();
@@ -315,6 +346,8 @@ namespace nfx::string::benchmark
 	static void BM_StringBuilderPool_BufferReuse( ::benchmark::State& state )
 	{
 		// Test buffer reuse efficiency
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			// Multiple consecutive uses to test pooling
@@ -342,6 +375,8 @@ namespace nfx::string::benchmark
 	static void BM_StringBuilderPool_ZeroAlloc( ::benchmark::State& state )
 	{
 		// Test pure builder operations without final string conversion
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			auto lease = StringBuilderPool::lease();
@@ -365,6 +400,8 @@ namespace nfx::string::benchmark
 	static void BM_StringBuilderPool_MemoryPressure( ::benchmark::State& state )
 	{
 		// Simulate memory pressure with large strings
+		BenchmarkCounters counters{ state };
+
 		for ( auto _ : state )
 		{
 			auto lease = StringBuilderPool::lease();
@@ -383,6 +420,98 @@ namespace nfx::string::benchmark
 			::benchmark::DoNotOptimize( result );
 		}
 	}
+
+	//----------------------------------------------
+	// Heterogeneous lookup
+	//----------------------------------------------
+
+	static const std::vector<std::string_view> lookup_ids = {
+		"1001", "1002", "1003", "1004", "1005", "1006", "1007", "1008" };
+
+	template <typename Map>
+	static Map makeLookupMap()
+	{
+		Map map;
+		for ( const auto& id : lookup_ids )
+		{
+			map.emplace( std::string{ "session:user-profile:" }.append( id ), static_cast<int>( map.size() ) );
+		}
+
+		return map;
+	}
+
+	static void BM_StdString_KeyLookup( ::benchmark::State& state )
+	{
+		const auto map{ makeLookupMap<std::unordered_map<std::string, int>>() };
+
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			int found = 0;
+
+			for ( const auto& id : lookup_ids )
+			{
+				auto lease = StringBuilderPool::lease();
+				auto builder = lease.create();
+				builder << "session:" << "user-profile:" << id;
+
+				auto it = map.find( lease.toString() );
+				found += it != map.end() ? it->second : 0;
+			}
+
+			::benchmark::DoNotOptimize( found );
+		}
+	}
+
+	static void BM_StringBuilderPool_KeyLookup( ::benchmark::State& state )
+	{
+		const auto map{ makeLookupMap<std::unordered_map<std::string, int, StringKeyHash, StringKeyEqual>>() };
+
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			int found = 0;
+
+			for ( const auto& id : lookup_ids )
+			{
+				auto lease = StringBuilderPool::lease();
+				auto builder = lease.create();
+				builder << "session:" << "user-profile:" << id;
+
+				auto it = map.find( lease.key() );
+				found += it != map.end() ? it->second : 0;
+			}
+
+			::benchmark::DoNotOptimize( found );
+		}
+	}
+
+	static void BM_StringBuilderPool_KeyLookupIncrementalHash( ::benchmark::State& state )
+	{
+		const auto map{ makeLookupMap<std::unordered_map<std::string, int, StringKeyHash, StringKeyEqual>>() };
+
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			int found = 0;
+
+			for ( const auto& id : lookup_ids )
+			{
+				auto lease = StringBuilderPool::lease();
+				lease.buffer().enableIncrementalHash();
+				auto builder = lease.create();
+				builder << "session:" << "user-profile:" << id;
+
+				auto it = map.find( lease.key() );
+				found += it != map.end() ? it->second : 0;
+			}
+
+			::benchmark::DoNotOptimize( found );
+		}
+	}
 } // namespace nfx::string::benchmark
 
 //=====================================================================
@@ -497,4 +626,20 @@ BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_MemoryPressure )
 	->MinTime( 1.0 )
 	->Unit( benchmark::kNanosecond );
 
+//----------------------------------------------
+// Heterogeneous lookup
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_KeyLookup )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_KeyLookup )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_KeyLookupIncrementalHash )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
 BENCHMARK_MAIN();
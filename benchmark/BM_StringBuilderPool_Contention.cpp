@@ -0,0 +1,496 @@
+/**
+ * @file BM_StringBuilderPool_Contention.cpp
+ * @brief Multi-threaded contention benchmarks for StringBuilderPool vs new/delete and std::string
+ * @details Every scenario runs at 1..64 threads. Besides wall time, each case reports:
+ *          - per_thread_ops: operations per second achieved by one thread
+ *          - scaling_efficiency: per_thread_ops relative to the single-thread run of the same case
+ *            (1.0 = perfect scaling, lower values show contention)
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nfx/string/StringBuilderPool.h>
+
+namespace nfx::string::benchmark
+{
+	//=====================================================================
+	// Contention benchmark suite
+	//=====================================================================
+
+	//----------------------------------------------
+	// Test data
+	//----------------------------------------------
+
+	static const std::array<std::string_view, 4> message_parts = {
+		"worker", "request=42", "status=ok", "elapsed=17ms" };
+
+	/** @brief Leases held at once by one thread in the bursty scenario */
+	static constexpr size_t BURST_SIZE = 32;
+
+	/** @brief Block size of the new/delete baseline, large enough for one message */
+	static constexpr size_t MESSAGE_CAPACITY = 64;
+
+	/** @brief Capacity of one producer/consumer channel */
+	static constexpr size_t CHANNEL_CAPACITY = 64;
+
+	//----------------------------------------------
+	// Workloads
+	//----------------------------------------------
+
+	/** @brief Builds messages in pooled leases */
+	struct PoolWorkload
+	{
+		using Item = StringBuilderLease;
+
+		static Item acquire()
+		{
+			auto lease = StringBuilderPool::lease();
+			auto builder = lease.create();
+			for ( const auto& part : message_parts )
+			{
+				builder << part << ' ';
+			}
+
+			return lease;
+		}
+
+		/** @brief Lease that is released on another thread - returns to the shared tier */
+		static Item acquireForHandoff()
+		{
+			auto lease = StringBuilderPool::asyncLease();
+			auto builder = lease.create();
+			for ( const auto& part : message_parts )
+			{
+				builder << part << ' ';
+			}
+
+			return lease;
+		}
+	};
+
+	/** @brief Builds messages in std::string */
+	struct StdStringWorkload
+	{
+		using Item = std::string;
+
+		static Item acquire()
+		{
+			std::string result;
+			for ( const auto& part : message_parts )
+			{
+				result += part;
+				result += ' ';
+			}
+
+			return result;
+		}
+
+		static Item acquireForHandoff()
+		{
+			return acquire();
+		}
+	};
+
+	/** @brief Copies messages into a raw new[]/delete[] block */
+	struct NewDeleteWorkload
+	{
+		using Item = std::unique_ptr<char[]>;
+
+		static Item acquire()
+		{
+			auto result = std::unique_ptr<char[]>{ new char[MESSAGE_CAPACITY] };
+			size_t offset = 0;
+			for ( const auto& part : message_parts )
+			{
+				std::memcpy( result.get() + offset, part.data(), part.size() );
+				offset += part.size();
+				result[offset++] = ' ';
+			}
+
+			return result;
+		}
+
+		static Item acquireForHandoff()
+		{
+			return acquire();
+		}
+	};
+
+	//----------------------------------------------
+	// Throughput reporting
+	//----------------------------------------------
+
+	/**
+	 * @brief Scope guard reporting per-thread throughput and scaling efficiency
+	 * @details The single-thread rate of each case is remembered as the baseline for its
+	 *          multi-threaded runs, which ThreadRange() always executes afterwards. Cases are
+	 *          identified by the address of a tag local to each scenario instantiation.
+	 */
+	class ThroughputReporter final
+	{
+	public:
+		ThroughputReporter( ::benchmark::State& state, size_t operationsPerIteration, const void* caseTag )
+			: m_state{ state },
+			  m_operationsPerIteration{ operationsPerIteration },
+			  m_caseTag{ caseTag },
+			  m_start{ std::chrono::steady_clock::now() }
+		{
+		}
+
+		~ThroughputReporter()
+		{
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+			const double operations = static_cast<double>( m_state.iterations() * m_operationsPerIteration );
+			const double rate = elapsed.count() > 0.0 ? operations / elapsed.count() : 0.0;
+
+			m_state.SetItemsProcessed( static_cast<int64_t>( operations ) );
+			m_state.counters["per_thread_ops"] = ::benchmark::Counter( rate, ::benchmark::Counter::kAvgThreads );
+
+			const double baseline = baselineRate( rate );
+			if ( baseline > 0.0 )
+			{
+				m_state.counters["scaling_efficiency"] =
+					::benchmark::Counter( rate / baseline, ::benchmark::Counter::kAvgThreads );
+			}
+		}
+
+		ThroughputReporter( const ThroughputReporter& ) = delete;
+		ThroughputReporter& operator=( const ThroughputReporter& ) = delete;
+
+	private:
+		double baselineRate( double rate ) const
+		{
+			static std::mutex mutex;
+			static std::map<const void*, double> baselines;
+
+			std::lock_guard<std::mutex> lock{ mutex };
+			if ( m_state.threads() == 1 )
+			{
+				baselines[m_caseTag] = rate;
+			}
+			const auto it = baselines.find( m_caseTag );
+
+			return it != baselines.end() ? it->second : 0.0;
+		}
+
+		::benchmark::State& m_state;
+		const size_t m_operationsPerIteration;
+		const void* m_caseTag;
+		const std::chrono::steady_clock::time_point m_start;
+	};
+
+	//----------------------------------------------
+	// Hand-off channels
+	//----------------------------------------------
+
+	/** @brief Bounded blocking queue moving items between threads */
+	template <typename Item>
+	class Channel final
+	{
+	public:
+		void push( Item item )
+		{
+			std::unique_lock<std::mutex> lock{ m_mutex };
+			m_notFull.wait( lock, [this] { return m_items.size() < CHANNEL_CAPACITY; } );
+			m_items.push_back( std::move( item ) );
+			m_notEmpty.notify_one();
+		}
+
+		Item pop()
+		{
+			std::unique_lock<std::mutex> lock{ m_mutex };
+			m_notEmpty.wait( lock, [this] { return !m_items.empty(); } );
+			Item item = std::move( m_items.front() );
+			m_items.pop_front();
+			m_notFull.notify_one();
+
+			return item;
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_notEmpty;
+		std::condition_variable m_notFull;
+		std::deque<Item> m_items;
+	};
+
+	/** @brief One channel per producer/consumer pair of the largest thread count */
+	template <typename Item>
+	std::array<Channel<Item>, 32>& pairChannels()
+	{
+		static std::array<Channel<Item>, 32> channels;
+		return channels;
+	}
+
+	/** @brief Shared mailbox all threads deposit into and take from */
+	template <typename Item>
+	Channel<Item>& mailbox()
+	{
+		static Channel<Item> channel;
+		return channel;
+	}
+
+	//----------------------------------------------
+	// Scenarios
+	//----------------------------------------------
+
+	/** @brief Three leases held at once - the inner ones miss the thread-local cache */
+	template <typename Workload>
+	static void runNestedLeases( ::benchmark::State& state )
+	{
+		static const char tag{};
+		ThroughputReporter reporter{ state, 3, &tag };
+
+		for ( auto _ : state )
+		{
+			auto outer = Workload::acquire();
+			{
+				auto middle = Workload::acquire();
+				{
+					auto inner = Workload::acquire();
+					::benchmark::DoNotOptimize( inner );
+				}
+				::benchmark::DoNotOptimize( middle );
+			}
+			::benchmark::DoNotOptimize( outer );
+		}
+	}
+
+	/** @brief Each thread releases an item built by whichever thread deposited it last */
+	template <typename Workload>
+	static void runCrossThreadRelease( ::benchmark::State& state )
+	{
+		static const char tag{};
+		ThroughputReporter reporter{ state, 1, &tag };
+		auto& channel = mailbox<typename Workload::Item>();
+
+		for ( auto _ : state )
+		{
+			channel.push( Workload::acquireForHandoff() );
+			auto item = channel.pop();
+			::benchmark::DoNotOptimize( item );
+		}
+	}
+
+	/** @brief Even threads build, odd threads release - an unpaired last thread does both */
+	template <typename Workload>
+	static void runProducerConsumer( ::benchmark::State& state )
+	{
+		static const char tag{};
+		ThroughputReporter reporter{ state, 1, &tag };
+
+		const int pair = state.thread_index() / 2;
+		const bool isProducer = state.thread_index() % 2 == 0;
+		const bool isUnpaired = isProducer && state.thread_index() + 1 == state.threads();
+		auto& channel = pairChannels<typename Workload::Item>()[static_cast<size_t>( pair )];
+
+		for ( auto _ : state )
+		{
+			if ( isUnpaired )
+			{
+				channel.push( Workload::acquireForHandoff() );
+				auto item = channel.pop();
+				::benchmark::DoNotOptimize( item );
+			}
+			else if ( isProducer )
+			{
+				channel.push( Workload::acquireForHandoff() );
+			}
+			else
+			{
+				auto item = channel.pop();
+				::benchmark::DoNotOptimize( item );
+			}
+		}
+	}
+
+	/** @brief Bursts of BURST_SIZE simultaneous leases released together */
+	template <typename Workload>
+	static void runBursty( ::benchmark::State& state )
+	{
+		static const char tag{};
+		ThroughputReporter reporter{ state, BURST_SIZE, &tag };
+
+		std::vector<typename Workload::Item> burst;
+		burst.reserve( BURST_SIZE );
+
+		for ( auto _ : state )
+		{
+			for ( size_t i = 0; i < BURST_SIZE; ++i )
+			{
+				burst.push_back( Workload::acquire() );
+			}
+			::benchmark::DoNotOptimize( burst.data() );
+			burst.clear();
+		}
+	}
+
+	//----------------------------------------------
+	// Nested leases
+	//----------------------------------------------
+
+	static void BM_NewDelete_NestedLeases( ::benchmark::State& state )
+	{
+		runNestedLeases<NewDeleteWorkload>( state );
+	}
+
+	static void BM_StdString_NestedLeases( ::benchmark::State& state )
+	{
+		runNestedLeases<StdStringWorkload>( state );
+	}
+
+	static void BM_StringBuilderPool_NestedLeases( ::benchmark::State& state )
+	{
+		runNestedLeases<PoolWorkload>( state );
+	}
+
+	//----------------------------------------------
+	// Cross-thread release
+	//----------------------------------------------
+
+	static void BM_NewDelete_CrossThreadRelease( ::benchmark::State& state )
+	{
+		runCrossThreadRelease<NewDeleteWorkload>( state );
+	}
+
+	static void BM_StdString_CrossThreadRelease( ::benchmark::State& state )
+	{
+		runCrossThreadRelease<StdStringWorkload>( state );
+	}
+
+	static void BM_StringBuilderPool_CrossThreadRelease( ::benchmark::State& state )
+	{
+		runCrossThreadRelease<PoolWorkload>( state );
+	}
+
+	//----------------------------------------------
+	// Producer/consumer hand-off
+	//----------------------------------------------
+
+	static void BM_NewDelete_ProducerConsumer( ::benchmark::State& state )
+	{
+		runProducerConsumer<NewDeleteWorkload>( state );
+	}
+
+	static void BM_StdString_ProducerConsumer( ::benchmark::State& state )
+	{
+		runProducerConsumer<StdStringWorkload>( state );
+	}
+
+	static void BM_StringBuilderPool_ProducerConsumer( ::benchmark::State& state )
+	{
+		runProducerConsumer<PoolWorkload>( state );
+	}
+
+	//----------------------------------------------
+	// Bursty workload
+	//----------------------------------------------
+
+	static void BM_NewDelete_Bursty( ::benchmark::State& state )
+	{
+		runBursty<NewDeleteWorkload>( state );
+	}
+
+	static void BM_StdString_Bursty( ::benchmark::State& state )
+	{
+		runBursty<StdStringWorkload>( state );
+	}
+
+	static void BM_StringBuilderPool_Bursty( ::benchmark::State& state )
+	{
+		runBursty<PoolWorkload>( state );
+	}
+} // namespace nfx::string::benchmark
+
+//=====================================================================
+// Benchmarks registration
+//=====================================================================
+
+//----------------------------------------------
+// Nested leases
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_NewDelete_NestedLeases )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_NestedLeases )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_NestedLeases )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// Cross-thread release
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_NewDelete_CrossThreadRelease )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_CrossThreadRelease )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_CrossThreadRelease )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// Producer/consumer hand-off
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_NewDelete_ProducerConsumer )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_ProducerConsumer )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_ProducerConsumer )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// Bursty workload
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_NewDelete_Bursty )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_Bursty )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_Bursty )
+	->ThreadRange( 1, 64 )
+	->UseRealTime()
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,419 @@
+/**
+ * @file BM_StringBuilderPool_Memory.cpp
+ * @brief Memory footprint benchmark reporting what the pool retains after standard workloads
+ * @details Runs each workload on 1..N threads. When every worker has finished, and while all of
+ *          them are still alive, it records:
+ *          - Retained bytes in the shared pool and in the workers' thread-local caches
+ *          - Process RSS and peak RSS (/proc/self/status, Linux)
+ *          - Heap arena size, bytes in use and free-chunk fragmentation (glibc mallinfo2)
+ *
+ *          Results are printed as a table, or as JSON for tracking regressions across releases.
+ *
+ *          Usage: BM_StringBuilderPool_Memory [options]
+ *            --operations=N          Leases per thread (default 100000)
+ *            --threads=N[,N...]      Thread counts (default 1,2,4,8)
+ *            --workloads=W[,W...]    small, medium, large, mixed, nested (default all)
+ *            --json=PATH             Write JSON results ("-" for stdout instead of the table)
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined( __GLIBC__ ) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+#	include <malloc.h>
+#	define NFX_BENCHMARK_HAS_MALLINFO2 1
+#endif
+
+#include <nfx/string/StringBuilderPool.h>
+
+namespace nfx::string::benchmark
+{
+	//=====================================================================
+	// Memory footprint benchmark
+	//=====================================================================
+
+	//----------------------------------------------
+	// Workloads
+	//----------------------------------------------
+
+	static constexpr std::array<std::string_view, 5> workload_names = {
+		"small", "medium", "large", "mixed", "nested" };
+
+	static constexpr std::string_view payload =
+		"Memory footprint benchmark payload, appended repeatedly to reach the target size. ";
+
+	static void build( StringBuilder& builder, size_t bytes )
+	{
+		while ( builder.length() + payload.size() <= bytes )
+		{
+			builder << payload;
+		}
+		builder.append( payload.substr( 0, bytes - builder.length() ) );
+	}
+
+	static void runLease( size_t bytes )
+	{
+		auto lease = StringBuilderPool::lease();
+		auto builder = lease.create();
+		build( builder, bytes );
+	}
+
+	/** @brief One unit of a workload; i varies sizes deterministically */
+	static void runWorkload( std::string_view workload, uint64_t i )
+	{
+		if ( workload == "small" )
+		{
+			runLease( 32 );
+		}
+		else if ( workload == "medium" )
+		{
+			runLease( 200 );
+		}
+		else if ( workload == "large" )
+		{
+			runLease( 1500 );
+		}
+		else if ( workload == "mixed" )
+		{
+			// Mostly small, some large, 1 in 64 above the retained capacity
+			static constexpr std::array<size_t, 8> sizes = { 24, 64, 120, 200, 512, 1024, 1800, 64 };
+			runLease( i % 64 == 63 ? 16384 : sizes[i % sizes.size()] );
+		}
+		else
+		{
+			// Four leases held at once push three buffers through the shared pool
+			auto first = StringBuilderPool::lease();
+			auto second = StringBuilderPool::lease();
+			auto third = StringBuilderPool::lease();
+			auto fourth = StringBuilderPool::lease();
+			auto builder = fourth.create();
+			build( builder, 600 );
+		}
+	}
+
+	//----------------------------------------------
+	// Process memory
+	//----------------------------------------------
+
+	struct ProcessMemory
+	{
+		uint64_t rssBytes = 0;
+		uint64_t peakRssBytes = 0;
+		uint64_t heapArenaBytes = 0;
+		uint64_t heapInUseBytes = 0;
+		uint64_t heapFreeBytes = 0;
+	};
+
+	/** @brief Resets the peak RSS counter (Linux 4.0+), best effort */
+	static void resetPeakRss()
+	{
+		std::ofstream clearRefs{ "/proc/self/clear_refs" };
+		if ( clearRefs )
+		{
+			clearRefs << "5";
+		}
+	}
+
+	static ProcessMemory readProcessMemory()
+	{
+		ProcessMemory memory;
+
+		std::ifstream status{ "/proc/self/status" };
+		std::string line;
+		while ( std::getline( status, line ) )
+		{
+			const auto readKilobytes = [&line]( std::string_view key, uint64_t& bytes ) {
+				if ( line.starts_with( key ) )
+				{
+					bytes = std::stoull( line.substr( key.size() ) ) * 1024;
+				}
+			};
+			readKilobytes( "VmRSS:", memory.rssBytes );
+			readKilobytes( "VmHWM:", memory.peakRssBytes );
+		}
+
+#if defined( NFX_BENCHMARK_HAS_MALLINFO2 )
+		const struct mallinfo2 info = ::mallinfo2();
+		memory.heapArenaBytes = info.arena + info.hblkhd;
+		memory.heapInUseBytes = info.uordblks + info.hblkhd;
+		memory.heapFreeBytes = info.fordblks;
+#endif
+
+		return memory;
+	}
+
+	//----------------------------------------------
+	// Measurement
+	//----------------------------------------------
+
+	struct CaseResult
+	{
+		std::string_view workload;
+		size_t threads = 0;
+		uint64_t operations = 0;
+		StringBuilderPool::MemoryUsage shared{};
+		size_t threadLocalBuffers = 0;
+		uint64_t threadLocalBytes = 0;
+		ProcessMemory process{};
+		uint64_t newAllocations = 0;
+		uint64_t oversizeShrinks = 0;
+		uint64_t poolFullDiscards = 0;
+
+		uint64_t retainedBytes() const noexcept
+		{
+			return shared.sharedPoolBytes + threadLocalBytes;
+		}
+
+		double fragmentation() const noexcept
+		{
+			return process.heapArenaBytes == 0
+					   ? 0.0
+					   : static_cast<double>( process.heapFreeBytes ) / static_cast<double>( process.heapArenaBytes );
+		}
+	};
+
+	static CaseResult runCase( std::string_view workload, size_t threads, uint64_t operations )
+	{
+		StringBuilderPool::clear();
+		StringBuilderPool::resetStats();
+		resetPeakRss();
+
+		CaseResult result{ .workload = workload, .threads = threads, .operations = operations };
+
+		std::mutex resultMutex;
+		std::latch finished{ static_cast<std::ptrdiff_t>( threads ) };
+		std::latch measured{ 1 };
+
+		std::vector<std::thread> workers;
+		for ( size_t t = 0; t < threads; ++t )
+		{
+			workers.emplace_back( [&]() {
+				for ( uint64_t i = 0; i < operations; ++i )
+				{
+					runWorkload( workload, i );
+				}
+
+				const auto usage = StringBuilderPool::memoryUsage();
+				{
+					std::lock_guard<std::mutex> lock{ resultMutex };
+					result.threadLocalBuffers += usage.threadLocalBuffers;
+					result.threadLocalBytes += usage.threadLocalBytes;
+				}
+
+				// Stay alive, keeping the thread cache, until the process has been measured
+				finished.count_down();
+				measured.wait();
+			} );
+		}
+
+		finished.wait();
+		result.shared = StringBuilderPool::memoryUsage();
+		result.process = readProcessMemory();
+		measured.count_down();
+
+		for ( auto& worker : workers )
+		{
+			worker.join();
+		}
+
+		const auto stats = StringBuilderPool::stats();
+		result.newAllocations = stats.newAllocations;
+		result.oversizeShrinks = stats.oversizeShrinks;
+		result.poolFullDiscards = stats.poolFullDiscards;
+
+		return result;
+	}
+
+	//----------------------------------------------
+	// Reporting
+	//----------------------------------------------
+
+	static void printTable( const std::vector<CaseResult>& results )
+	{
+		std::printf( "%-8s %7s | %7s %12s %7s %12s %12s | %12s %12s %12s %8s | %8s\n",
+			"workload", "threads", "shared", "shared B", "local", "local B", "retained B",
+			"RSS B", "peak RSS B", "heap B", "frag", "new bufs" );
+
+		for ( const auto& result : results )
+		{
+			std::printf( "%-8.*s %7zu | %7zu %12llu %7zu %12llu %12llu | %12llu %12llu %12llu %8.4f | %8llu\n",
+				static_cast<int>( result.workload.size() ), result.workload.data(), result.threads,
+				result.shared.sharedPoolBuffers,
+				static_cast<unsigned long long>( result.shared.sharedPoolBytes ),
+				result.threadLocalBuffers,
+				static_cast<unsigned long long>( result.threadLocalBytes ),
+				static_cast<unsigned long long>( result.retainedBytes() ),
+				static_cast<unsigned long long>( result.process.rssBytes ),
+				static_cast<unsigned long long>( result.process.peakRssBytes ),
+				static_cast<unsigned long long>( result.process.heapInUseBytes ),
+				result.fragmentation(),
+				static_cast<unsigned long long>( result.newAllocations ) );
+		}
+	}
+
+	static void writeJson( std::ostream& out, const std::vector<CaseResult>& results )
+	{
+		out << "{\n";
+		out << "  \"benchmark\": \"BM_StringBuilderPool_Memory\",\n";
+		out << "  \"bufferObjectBytes\": " << sizeof( DynamicStringBuffer ) << ",\n";
+		out << "  \"results\": [\n";
+		for ( size_t i = 0; i < results.size(); ++i )
+		{
+			const auto& result = results[i];
+			out << "    {";
+			out << "\"workload\": \"" << result.workload << "\", ";
+			out << "\"threads\": " << result.threads << ", ";
+			out << "\"operationsPerThread\": " << result.operations << ", ";
+			out << "\"sharedPoolBuffers\": " << result.shared.sharedPoolBuffers << ", ";
+			out << "\"sharedPoolBytes\": " << result.shared.sharedPoolBytes << ", ";
+			out << "\"threadLocalBuffers\": " << result.threadLocalBuffers << ", ";
+			out << "\"threadLocalBytes\": " << result.threadLocalBytes << ", ";
+			out << "\"retainedBytes\": " << result.retainedBytes() << ", ";
+			out << "\"rssBytes\": " << result.process.rssBytes << ", ";
+			out << "\"peakRssBytes\": " << result.process.peakRssBytes << ", ";
+			out << "\"heapArenaBytes\": " << result.process.heapArenaBytes << ", ";
+			out << "\"heapInUseBytes\": " << result.process.heapInUseBytes << ", ";
+			out << "\"heapFreeBytes\": " << result.process.heapFreeBytes << ", ";
+			out << "\"fragmentation\": " << result.fragmentation() << ", ";
+			out << "\"newAllocations\": " << result.newAllocations << ", ";
+			out << "\"oversizeShrinks\": " << result.oversizeShrinks << ", ";
+			out << "\"poolFullDiscards\": " << result.poolFullDiscards;
+			out << ( i + 1 < results.size() ? "},\n" : "}\n" );
+		}
+		out << "  ]\n";
+		out << "}\n";
+	}
+
+	//----------------------------------------------
+	// Options
+	//----------------------------------------------
+
+	struct Options
+	{
+		uint64_t operations = 100'000;
+		std::vector<size_t> threads{ 1, 2, 4, 8 };
+		std::vector<std::string_view> workloads{ workload_names.begin(), workload_names.end() };
+		std::string jsonPath;
+	};
+
+	static std::vector<std::string_view> splitList( std::string_view value )
+	{
+		std::vector<std::string_view> items;
+		while ( !value.empty() )
+		{
+			const auto comma = value.find( ',' );
+			items.push_back( value.substr( 0, comma ) );
+			value = comma == std::string_view::npos ? std::string_view{} : value.substr( comma + 1 );
+		}
+
+		return items;
+	}
+
+	static Options parseOptions( int argc, char** argv )
+	{
+		Options options;
+		for ( int i = 1; i < argc; ++i )
+		{
+			const std::string_view argument{ argv[i] };
+			const auto equals = argument.find( '=' );
+			const auto key = argument.substr( 0, equals );
+			const auto value = equals == std::string_view::npos ? std::string_view{} : argument.substr( equals + 1 );
+
+			if ( key == "--operations" )
+			{
+				options.operations = std::stoull( std::string{ value } );
+			}
+			else if ( key == "--threads" )
+			{
+				options.threads.clear();
+				for ( const auto item : splitList( value ) )
+				{
+					options.threads.push_back( std::max<size_t>( 1, std::stoul( std::string{ item } ) ) );
+				}
+			}
+			else if ( key == "--workloads" )
+			{
+				options.workloads = splitList( value );
+				for ( const auto workload : options.workloads )
+				{
+					if ( std::find( workload_names.begin(), workload_names.end(), workload ) == workload_names.end() )
+					{
+						throw std::invalid_argument{ "unknown workload: " + std::string{ workload } };
+					}
+				}
+			}
+			else if ( key == "--json" )
+			{
+				options.jsonPath = value;
+			}
+			else
+			{
+				throw std::invalid_argument{ "unknown option: " + std::string{ argument } };
+			}
+		}
+
+		return options;
+	}
+
+	static int run( const Options& options )
+	{
+		std::vector<CaseResult> results;
+		for ( const auto workload : options.workloads )
+		{
+			for ( const auto threads : options.threads )
+			{
+				results.push_back( runCase( workload, threads, options.operations ) );
+			}
+		}
+
+		if ( options.jsonPath == "-" )
+		{
+			writeJson( std::cout, results );
+			return EXIT_SUCCESS;
+		}
+
+		printTable( results );
+		if ( !options.jsonPath.empty() )
+		{
+			std::ofstream file{ options.jsonPath };
+			if ( !file )
+			{
+				std::fprintf( stderr, "Cannot open %s\n", options.jsonPath.c_str() );
+				return EXIT_FAILURE;
+			}
+			writeJson( file, results );
+		}
+
+		return EXIT_SUCCESS;
+	}
+} // namespace nfx::string::benchmark
+
+//=====================================================================
+// Entry point
+//=====================================================================
+
+int main( int argc, char** argv )
+{
+	try
+	{
+		return nfx::string::benchmark::run( nfx::string::benchmark::parseOptions( argc, argv ) );
+	}
+	catch ( const std::exception& e )
+	{
+		std::fprintf( stderr, "Error: %s\n", e.what() );
+		return EXIT_FAILURE;
+	}
+}
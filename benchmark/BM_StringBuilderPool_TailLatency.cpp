@@ -0,0 +1,429 @@
+/**
+ * @file BM_StringBuilderPool_TailLatency.cpp
+ * @brief Tail-latency benchmark timing every lease + build + release cycle individually
+ * @details Means hide the rare slow cycles (new allocations, reallocating growths, oversize shrinks)
+ *          that drive p99. This executable times each cycle, records it into a
+ *          StringBuilderPool::Histogram per operation kind and prints percentile tables plus an
+ *          HdrHistogram-compatible percentile distribution (.hgrm).
+ *
+ *          Usage: BM_StringBuilderPool_TailLatency [options]
+ *            --operations=N   Cycles per thread (default 1000000)
+ *            --threads=N      Worker threads (default 1)
+ *            --mix=SPEC       Load mix as kind=weight pairs (default small=70,medium=20,large=8,huge=1,nested=1)
+ *                             Kinds: small, medium, large (heap growth), huge (oversize shrink), nested
+ *            --seed=N         Operation sequence seed (default 42)
+ *            --hdr=PATH       Write the overall distribution in .hgrm format ("-" for stdout)
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nfx/string/StringBuilderPool.h>
+
+namespace nfx::string::benchmark
+{
+	//=====================================================================
+	// Tail-latency benchmark
+	//=====================================================================
+
+	//----------------------------------------------
+	// Operation kinds
+	//----------------------------------------------
+
+	enum class Operation : uint8_t
+	{
+		Small = 0,
+		Medium,
+		Large,
+		Huge,
+		Nested,
+	};
+
+	static constexpr size_t OPERATION_COUNT = 5;
+
+	static constexpr std::array<std::string_view, OPERATION_COUNT> operation_names = {
+		"small", "medium", "large", "huge", "nested" };
+
+	/** @brief Bytes appended by each operation kind */
+	static constexpr std::array<size_t, OPERATION_COUNT> operation_sizes = {
+		32,	  // Fits the stack buffer
+		200,  // Fits the pooled capacity
+		1024, // Grows past the stack buffer
+		8192, // Exceeds the retained capacity - shrunk on return
+		64,	  // Two leases held at once
+	};
+
+	//----------------------------------------------
+	// Options
+	//----------------------------------------------
+
+	struct Options
+	{
+		uint64_t operations = 1'000'000;
+		size_t threads = 1;
+		std::array<uint32_t, OPERATION_COUNT> mix{ 70, 20, 8, 1, 1 };
+		uint32_t seed = 42;
+		std::string hdrPath;
+	};
+
+	static std::array<uint32_t, OPERATION_COUNT> parseMix( std::string_view spec )
+	{
+		std::array<uint32_t, OPERATION_COUNT> mix{};
+		while ( !spec.empty() )
+		{
+			const auto comma = spec.find( ',' );
+			const auto entry = spec.substr( 0, comma );
+			spec = comma == std::string_view::npos ? std::string_view{} : spec.substr( comma + 1 );
+
+			const auto equals = entry.find( '=' );
+			if ( equals == std::string_view::npos )
+			{
+				throw std::invalid_argument{ "mix entry without '=': " + std::string{ entry } };
+			}
+
+			const auto name = entry.substr( 0, equals );
+			const auto it = std::find( operation_names.begin(), operation_names.end(), name );
+			if ( it == operation_names.end() )
+			{
+				throw std::invalid_argument{ "unknown operation kind: " + std::string{ name } };
+			}
+			mix[static_cast<size_t>( it - operation_names.begin() )] =
+				static_cast<uint32_t>( std::stoul( std::string{ entry.substr( equals + 1 ) } ) );
+		}
+
+		return mix;
+	}
+
+	static Options parseOptions( int argc, char** argv )
+	{
+		Options options;
+		for ( int i = 1; i < argc; ++i )
+		{
+			const std::string_view argument{ argv[i] };
+			const auto equals = argument.find( '=' );
+			const auto key = argument.substr( 0, equals );
+			const std::string value{ equals == std::string_view::npos ? std::string_view{} : argument.substr( equals + 1 ) };
+
+			if ( key == "--operations" )
+			{
+				options.operations = std::stoull( value );
+			}
+			else if ( key == "--threads" )
+			{
+				options.threads = std::max<size_t>( 1, std::stoul( value ) );
+			}
+			else if ( key == "--mix" )
+			{
+				options.mix = parseMix( value );
+			}
+			else if ( key == "--seed" )
+			{
+				options.seed = static_cast<uint32_t>( std::stoul( value ) );
+			}
+			else if ( key == "--hdr" )
+			{
+				options.hdrPath = value;
+			}
+			else
+			{
+				throw std::invalid_argument{ "unknown option: " + std::string{ argument } };
+			}
+		}
+
+		return options;
+	}
+
+	//----------------------------------------------
+	// Measurement
+	//----------------------------------------------
+
+	using Clock = std::chrono::steady_clock;
+
+	/** @brief Latencies of one worker, in nanoseconds */
+	struct LatencyRecord
+	{
+		std::array<StringBuilderPool::Histogram, OPERATION_COUNT> byOperation{};
+		StringBuilderPool::Histogram overall{};
+	};
+
+	static void build( StringBuilder& builder, size_t bytes )
+	{
+		static constexpr std::string_view chunk = "latency-benchmark-payload-chunk.";
+		while ( builder.length() + chunk.size() <= bytes )
+		{
+			builder << chunk;
+		}
+		builder.append( chunk.substr( 0, bytes - builder.length() ) );
+	}
+
+	static void runOperation( Operation operation )
+	{
+		const size_t bytes = operation_sizes[static_cast<size_t>( operation )];
+
+		auto lease = StringBuilderPool::lease();
+		auto builder = lease.create();
+		build( builder, bytes );
+
+		if ( operation == Operation::Nested )
+		{
+			auto inner = StringBuilderPool::lease();
+			auto innerBuilder = inner.create();
+			build( innerBuilder, bytes );
+			innerBuilder << builder.view( 0, 8 );
+		}
+	}
+
+	static void runWorker( const std::vector<Operation>& sequence, LatencyRecord& record )
+	{
+		for ( const auto operation : sequence )
+		{
+			const auto start = Clock::now();
+			runOperation( operation );
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+
+			const auto nanoseconds = static_cast<uint64_t>( elapsed );
+			record.byOperation[static_cast<size_t>( operation )].record( nanoseconds );
+			record.overall.record( nanoseconds );
+		}
+	}
+
+	/** @brief Median cost of two clock reads, included in every recorded latency */
+	static uint64_t clockOverhead()
+	{
+		StringBuilderPool::Histogram histogram{};
+		for ( int i = 0; i < 100'000; ++i )
+		{
+			const auto start = Clock::now();
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+			histogram.record( static_cast<uint64_t>( elapsed ) );
+		}
+
+		return histogram.percentile( 50.0 );
+	}
+
+	//----------------------------------------------
+	// Reporting
+	//----------------------------------------------
+
+	static constexpr std::array<double, 6> reported_percentiles = { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 };
+
+	static void printTable( const LatencyRecord& record )
+	{
+		std::printf( "%-8s %12s %10s %10s %10s %10s %10s %10s %10s\n",
+			"kind", "count", "mean", "p50", "p90", "p99", "p99.9", "p99.99", "max" );
+
+		const auto printRow = [&]( std::string_view name, const StringBuilderPool::Histogram& histogram ) {
+			if ( histogram.count == 0 )
+			{
+				return;
+			}
+
+			std::printf( "%-8.*s %12llu %10.1f", static_cast<int>( name.size() ), name.data(),
+				static_cast<unsigned long long>( histogram.count ), histogram.mean() );
+			for ( const double percentile : reported_percentiles )
+			{
+				std::printf( " %10llu", static_cast<unsigned long long>( histogram.percentile( percentile ) ) );
+			}
+			std::printf( "\n" );
+		};
+
+		for ( size_t i = 0; i < OPERATION_COUNT; ++i )
+		{
+			printRow( operation_names[i], record.byOperation[i] );
+		}
+		printRow( "all", record.overall );
+	}
+
+	/**
+	 * @brief Writes a percentile distribution in HdrHistogram's .hgrm text format
+	 * @details Values are reported in microseconds; percentile steps halve the remaining
+	 *          distance to 100% five ticks at a time, as HdrHistogram's outputPercentileDistribution.
+	 */
+	static void writeHgrm( std::ostream& out, const StringBuilderPool::Histogram& histogram )
+	{
+		constexpr double scale = 1000.0;
+		constexpr int ticksPerHalfDistance = 5;
+
+		char line[128];
+		out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+
+		if ( histogram.count > 0 )
+		{
+			uint64_t seen = 0;
+			double percentileTarget = 0.0;
+			for ( size_t i = 0; i < StringBuilderPool::Histogram::BUCKET_COUNT && seen < histogram.count; ++i )
+			{
+				if ( histogram.buckets[i] == 0 )
+				{
+					continue;
+				}
+				seen += histogram.buckets[i];
+
+				const double reached = static_cast<double>( seen ) / static_cast<double>( histogram.count );
+				if ( reached < percentileTarget && seen < histogram.count )
+				{
+					continue;
+				}
+
+				const double value = static_cast<double>( std::min( StringBuilderPool::Histogram::bucketUpperBound( i ), histogram.max ) ) / scale;
+				if ( seen == histogram.count )
+				{
+					std::snprintf( line, sizeof( line ), "%12.3f %2.12f %10llu\n",
+						value, 1.0, static_cast<unsigned long long>( seen ) );
+					out << line;
+					break;
+				}
+				std::snprintf( line, sizeof( line ), "%12.3f %2.12f %10llu %14.2f\n",
+					value, reached, static_cast<unsigned long long>( seen ), 1.0 / ( 1.0 - reached ) );
+				out << line;
+
+				// Advance the target past the reached percentile in ever smaller steps
+				while ( percentileTarget <= reached )
+				{
+					const double halfDistance = std::pow( 2.0, std::floor( std::log2( 1.0 / ( 1.0 - percentileTarget ) ) ) + 1.0 );
+					percentileTarget += 1.0 / ( halfDistance * ticksPerHalfDistance );
+				}
+			}
+		}
+
+		// Standard deviation from bucket midpoints
+		double variance = 0.0;
+		const double mean = histogram.mean();
+		for ( size_t i = 0; i < StringBuilderPool::Histogram::BUCKET_COUNT; ++i )
+		{
+			if ( histogram.buckets[i] != 0 )
+			{
+				const double midpoint = ( static_cast<double>( StringBuilderPool::Histogram::bucketLowerBound( i ) ) +
+											static_cast<double>( StringBuilderPool::Histogram::bucketUpperBound( i ) ) ) /
+										2.0;
+				variance += static_cast<double>( histogram.buckets[i] ) * ( midpoint - mean ) * ( midpoint - mean );
+			}
+		}
+		const double deviation = histogram.count > 0 ? std::sqrt( variance / static_cast<double>( histogram.count ) ) : 0.0;
+
+		std::snprintf( line, sizeof( line ), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean / scale, deviation / scale );
+		out << line;
+		std::snprintf( line, sizeof( line ), "#[Max     = %12.3f, Total count    = %12llu]\n",
+			static_cast<double>( histogram.max ) / scale, static_cast<unsigned long long>( histogram.count ) );
+		out << line;
+		std::snprintf( line, sizeof( line ), "#[Buckets = %12zu, SubBuckets     = %12zu]\n",
+			StringBuilderPool::Histogram::BUCKET_COUNT / StringBuilderPool::Histogram::SUB_BUCKET_COUNT,
+			StringBuilderPool::Histogram::SUB_BUCKET_COUNT );
+		out << line;
+	}
+
+	//----------------------------------------------
+	// Driver
+	//----------------------------------------------
+
+	static std::vector<Operation> makeSequence( const Options& options, uint32_t seed )
+	{
+		std::mt19937 random{ seed };
+		std::discrete_distribution<size_t> distribution{ options.mix.begin(), options.mix.end() };
+
+		std::vector<Operation> sequence( options.operations );
+		for ( auto& operation : sequence )
+		{
+			operation = static_cast<Operation>( distribution( random ) );
+		}
+
+		return sequence;
+	}
+
+	static int run( const Options& options )
+	{
+		std::vector<std::vector<Operation>> sequences;
+		for ( size_t t = 0; t < options.threads; ++t )
+		{
+			sequences.push_back( makeSequence( options, options.seed + static_cast<uint32_t>( t ) ) );
+		}
+
+		// Warm the shared pool and the clock before measuring
+		for ( size_t i = 0; i < 10'000; ++i )
+		{
+			runOperation( static_cast<Operation>( i % OPERATION_COUNT ) );
+		}
+		StringBuilderPool::resetStats();
+
+		std::vector<LatencyRecord> records( options.threads );
+		std::vector<std::thread> workers;
+		for ( size_t t = 0; t < options.threads; ++t )
+		{
+			workers.emplace_back( [&, t] { runWorker( sequences[t], records[t] ); } );
+		}
+		for ( auto& worker : workers )
+		{
+			worker.join();
+		}
+
+		LatencyRecord total;
+		for ( const auto& record : records )
+		{
+			for ( size_t i = 0; i < OPERATION_COUNT; ++i )
+			{
+				total.byOperation[i].merge( record.byOperation[i] );
+			}
+			total.overall.merge( record.overall );
+		}
+
+		const auto stats = StringBuilderPool::stats();
+		std::printf( "Lease + build + release latency (ns), %zu thread(s), %llu operations per thread, clock overhead ~%llu ns\n\n",
+			options.threads, static_cast<unsigned long long>( options.operations ),
+			static_cast<unsigned long long>( clockOverhead() ) );
+		printTable( total );
+		std::printf( "\nPool: hit rate %.4f, new allocations %llu, heap growths %llu, oversize shrinks %llu, pool-full discards %llu\n",
+			stats.hitRate, static_cast<unsigned long long>( stats.newAllocations ),
+			static_cast<unsigned long long>( stats.heapGrowths ),
+			static_cast<unsigned long long>( stats.oversizeShrinks ),
+			static_cast<unsigned long long>( stats.poolFullDiscards ) );
+
+		if ( options.hdrPath == "-" )
+		{
+			std::printf( "\n" );
+			std::fflush( stdout );
+			writeHgrm( std::cout, total.overall );
+		}
+		else if ( !options.hdrPath.empty() )
+		{
+			std::ofstream file{ options.hdrPath };
+			if ( !file )
+			{
+				std::fprintf( stderr, "Cannot open %s\n", options.hdrPath.c_str() );
+				return EXIT_FAILURE;
+			}
+			writeHgrm( file, total.overall );
+		}
+
+		return EXIT_SUCCESS;
+	}
+} // namespace nfx::string::benchmark
+
+//=====================================================================
+// Entry point
+//=====================================================================
+
+int main( int argc, char** argv )
+{
+	try
+	{
+		return nfx::string::benchmark::run( nfx::string::benchmark::parseOptions( argc, argv ) );
+	}
+	catch ( const std::exception& e )
+	{
+		std::fprintf( stderr, "Error: %s\n", e.what() );
+		return EXIT_FAILURE;
+	}
+}
@@ -0,0 +1,744 @@
+/**
+ * @file BM_StringBuilderPool_Workloads.cpp
+ * @brief Production-style workload benchmarks for StringBuilderPool vs standard alternatives
+ * @details Each workload builds a complete output (log line, JSON response, CSV export, HTTP
+ *          response headers, metric names) from typed records, the way application code does.
+ *          Baselines are std::string, std::ostringstream and, when the standard library provides
+ *          it, std::format. Pool variants consume the result as a view, as code handing the bytes
+ *          to a socket or file would.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <version>
+
+#if defined( __cpp_lib_format )
+#	include <format>
+#endif
+
+#include <nfx/string/StringBuilderPool.h>
+
+#include "BenchmarkCounters.h"
+
+namespace nfx::string::benchmark
+{
+	//=====================================================================
+	// Workload benchmark suite
+	//=====================================================================
+
+	//----------------------------------------------
+	// Test data
+	//----------------------------------------------
+
+	struct LogRecord
+	{
+		std::string_view timestamp;
+		std::string_view level;
+		std::string_view logger;
+		std::string_view message;
+		std::string_view requestId;
+		int64_t userId;
+		int64_t durationMicroseconds;
+		int status;
+	};
+
+	struct Product
+	{
+		int64_t id;
+		std::string_view name;
+		std::string_view category;
+		int64_t priceCents;
+		int stock;
+		bool active;
+	};
+
+	struct HttpHeader
+	{
+		std::string_view name;
+		std::string_view value;
+	};
+
+	struct MetricId
+	{
+		std::string_view service;
+		std::string_view region;
+		std::string_view host;
+		std::string_view metric;
+		int shard;
+	};
+
+	static const LogRecord log_record{
+		"2025-06-14T09:41:27.318Z", "INFO", "http.server.RequestHandler",
+		"request completed", "7f3c9a12-5b8e-4d21-a6f0-2c41e9b07d55", 1048576, 18342, 200 };
+
+	static const std::array<Product, 10> products = { {
+		{ 1001, "Wireless Mouse", "peripherals", 2499, 140, true },
+		{ 1002, "Mechanical Keyboard", "peripherals", 8999, 35, true },
+		{ 1003, "USB-C Hub", "accessories", 3450, 0, false },
+		{ 1004, "27in Monitor", "displays", 27900, 12, true },
+		{ 1005, "Laptop Stand", "accessories", 3999, 87, true },
+		{ 1006, "Webcam 1080p", "peripherals", 5999, 44, true },
+		{ 1007, "Noise Cancelling Headset", "audio", 14999, 9, true },
+		{ 1008, "Desk Lamp", "furniture", 2999, 61, false },
+		{ 1009, "Ergonomic Chair", "furniture", 34900, 4, true },
+		{ 1010, "Cable Kit, Braided", "accessories", 1599, 230, true },
+	} };
+
+	static const std::array<HttpHeader, 8> http_headers = { {
+		{ "Content-Type", "application/json; charset=utf-8" },
+		{ "Cache-Control", "no-store, max-age=0" },
+		{ "Date", "Sat, 14 Jun 2025 09:41:27 GMT" },
+		{ "Server", "nfx-http/1.4" },
+		{ "Strict-Transport-Security", "max-age=63072000; includeSubDomains" },
+		{ "X-Request-Id", "7f3c9a12-5b8e-4d21-a6f0-2c41e9b07d55" },
+		{ "Vary", "Accept-Encoding" },
+		{ "Connection", "keep-alive" },
+	} };
+
+	static const std::array<MetricId, 16> metric_ids = { {
+		{ "checkout", "eu-west-1", "web-01", "http_requests", 0 },
+		{ "checkout", "eu-west-1", "web-01", "http_errors", 0 },
+		{ "checkout", "eu-west-1", "web-02", "http_requests", 1 },
+		{ "checkout", "eu-west-1", "web-02", "http_errors", 1 },
+		{ "checkout", "us-east-1", "web-03", "http_requests", 2 },
+		{ "checkout", "us-east-1", "web-03", "http_errors", 2 },
+		{ "checkout", "us-east-1", "web-04", "http_requests", 3 },
+		{ "checkout", "us-east-1", "web-04", "http_errors", 3 },
+		{ "catalog", "eu-west-1", "api-01", "cache_hits", 0 },
+		{ "catalog", "eu-west-1", "api-01", "cache_misses", 0 },
+		{ "catalog", "eu-west-1", "api-02", "cache_hits", 1 },
+		{ "catalog", "eu-west-1", "api-02", "cache_misses", 1 },
+		{ "catalog", "us-east-1", "api-03", "cache_hits", 2 },
+		{ "catalog", "us-east-1", "api-03", "cache_misses", 2 },
+		{ "catalog", "us-east-1", "api-04", "cache_hits", 3 },
+		{ "catalog", "us-east-1", "api-04", "cache_misses", 3 },
+	} };
+
+	/** @brief Body length announced in the HTTP header workload */
+	static constexpr int64_t http_content_length = 18342;
+
+	//----------------------------------------------
+	// Output sinks
+	//----------------------------------------------
+
+	/** @brief Stream-style adapter over std::string so workloads share one writer per format */
+	class StdStringSink final
+	{
+	public:
+		explicit StdStringSink( std::string& target )
+			: m_target{ target }
+		{
+		}
+
+		StdStringSink& operator<<( std::string_view str )
+		{
+			m_target += str;
+			return *this;
+		}
+
+		StdStringSink& operator<<( char c )
+		{
+			m_target += c;
+			return *this;
+		}
+
+	private:
+		std::string& m_target;
+	};
+
+	/** @brief Appends an integer formatted with std::to_chars */
+	template <typename Sink>
+	static void appendNumber( Sink& out, int64_t value )
+	{
+		std::array<char, 24> digits;
+		const auto result = std::to_chars( digits.data(), digits.data() + digits.size(), value );
+		out << std::string_view{ digits.data(), static_cast<size_t>( result.ptr - digits.data() ) };
+	}
+
+	static void appendNumber( std::ostringstream& out, int64_t value )
+	{
+		out << value;
+	}
+
+	/** @brief Appends a price in cents as a decimal amount */
+	template <typename Sink>
+	static void appendPrice( Sink& out, int64_t cents )
+	{
+		appendNumber( out, cents / 100 );
+		out << '.';
+		const auto fraction = cents % 100;
+		out << static_cast<char>( '0' + fraction / 10 ) << static_cast<char>( '0' + fraction % 10 );
+	}
+
+	//----------------------------------------------
+	// Workload writers
+	//----------------------------------------------
+
+	/** @brief Structured log line: fixed prefix followed by key=value fields */
+	template <typename Sink>
+	static void writeLogLine( Sink& out, const LogRecord& record )
+	{
+		out << record.timestamp << ' ' << '[' << record.level << ']' << ' ' << record.logger << " - " << record.message;
+		out << " request_id=" << record.requestId;
+		out << " user_id=";
+		appendNumber( out, record.userId );
+		out << " duration_us=";
+		appendNumber( out, record.durationMicroseconds );
+		out << " status=";
+		appendNumber( out, record.status );
+		out << '\n';
+	}
+
+	/** @brief JSON response with a product array */
+	template <typename Sink>
+	static void writeJsonResponse( Sink& out )
+	{
+		out << "{\"status\":\"ok\",\"count\":";
+		appendNumber( out, static_cast<int64_t>( products.size() ) );
+		out << ",\"items\":[";
+		for ( size_t i = 0; i < products.size(); ++i )
+		{
+			const auto& product = products[i];
+			if ( i > 0 )
+			{
+				out << ',';
+			}
+			out << "{\"id\":";
+			appendNumber( out, product.id );
+			out << ",\"name\":\"" << product.name << "\",\"category\":\"" << product.category << "\",\"price\":";
+			appendPrice( out, product.priceCents );
+			out << ",\"stock\":";
+			appendNumber( out, product.stock );
+			out << ",\"active\":" << ( product.active ? std::string_view{ "true" } : std::string_view{ "false" } ) << '}';
+		}
+		out << "]}";
+	}
+
+	/** @brief CSV export with a header row and RFC 4180 quoting of fields containing commas */
+	template <typename Sink>
+	static void writeCsvExport( Sink& out )
+	{
+		out << "id,name,category,price,stock,active\r\n";
+		for ( const auto& product : products )
+		{
+			appendNumber( out, product.id );
+			out << ',';
+			if ( product.name.find( ',' ) != std::string_view::npos )
+			{
+				out << '"' << product.name << '"';
+			}
+			else
+			{
+				out << product.name;
+			}
+			out << ',' << product.category << ',';
+			appendPrice( out, product.priceCents );
+			out << ',';
+			appendNumber( out, product.stock );
+			out << ',' << ( product.active ? '1' : '0' ) << "\r\n";
+		}
+	}
+
+	/** @brief HTTP/1.1 response status line and headers */
+	template <typename Sink>
+	static void writeHttpHeaders( Sink& out )
+	{
+		out << "HTTP/1.1 200 OK\r\n";
+		for ( const auto& header : http_headers )
+		{
+			out << header.name << ": " << header.value << "\r\n";
+		}
+		out << "Content-Length: ";
+		appendNumber( out, http_content_length );
+		out << "\r\n\r\n";
+	}
+
+	/** @brief Dotted metric name with a shard tag */
+	template <typename Sink>
+	static void writeMetricName( Sink& out, const MetricId& id )
+	{
+		out << id.service << '.' << id.region << '.' << id.host << '.' << id.metric << ".shard_";
+		appendNumber( out, id.shard );
+	}
+
+#if defined( __cpp_lib_format )
+
+	//----------------------------------------------
+	// std::format writers
+	//----------------------------------------------
+
+	static void formatLogLine( std::string& out, const LogRecord& record )
+	{
+		std::format_to( std::back_inserter( out ), "{} [{}] {} - {} request_id={} user_id={} duration_us={} status={}\n",
+			record.timestamp, record.level, record.logger, record.message, record.requestId,
+			record.userId, record.durationMicroseconds, record.status );
+	}
+
+	static void formatJsonResponse( std::string& out )
+	{
+		std::format_to( std::back_inserter( out ), "{{\"status\":\"ok\",\"count\":{},\"items\":[", products.size() );
+		for ( size_t i = 0; i < products.size(); ++i )
+		{
+			const auto& product = products[i];
+			std::format_to( std::back_inserter( out ),
+				"{}{{\"id\":{},\"name\":\"{}\",\"category\":\"{}\",\"price\":{}.{:02},\"stock\":{},\"active\":{}}}",
+				i > 0 ? "," : "", product.id, product.name, product.category,
+				product.priceCents / 100, product.priceCents % 100, product.stock, product.active );
+		}
+		out += "]}";
+	}
+
+	static void formatCsvExport( std::string& out )
+	{
+		out += "id,name,category,price,stock,active\r\n";
+		for ( const auto& product : products )
+		{
+			const bool quote = product.name.find( ',' ) != std::string_view::npos;
+			std::format_to( std::back_inserter( out ), "{},{}{}{},{},{}.{:02},{},{}\r\n",
+				product.id, quote ? "\"" : "", product.name, quote ? "\"" : "", product.category,
+				product.priceCents / 100, product.priceCents % 100, product.stock, product.active ? 1 : 0 );
+		}
+	}
+
+	static void formatHttpHeaders( std::string& out )
+	{
+		out += "HTTP/1.1 200 OK\r\n";
+		for ( const auto& header : http_headers )
+		{
+			std::format_to( std::back_inserter( out ), "{}: {}\r\n", header.name, header.value );
+		}
+		std::format_to( std::back_inserter( out ), "Content-Length: {}\r\n\r\n", http_content_length );
+	}
+
+	static void formatMetricName( std::string& out, const MetricId& id )
+	{
+		std::format_to( std::back_inserter( out ), "{}.{}.{}.{}.shard_{}", id.service, id.region, id.host, id.metric, id.shard );
+	}
+
+#endif
+
+	//----------------------------------------------
+	// Structured log line
+	//----------------------------------------------
+
+	static void BM_StdString_LogLine( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			StdStringSink sink{ result };
+			writeLogLine( sink, log_record );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	static void BM_StringStream_LogLine( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::ostringstream oss;
+			writeLogLine( oss, log_record );
+			std::string result = oss.str();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+#if defined( __cpp_lib_format )
+	static void BM_StdFormat_LogLine( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			formatLogLine( result, log_record );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+#endif
+
+	static void BM_StringBuilderPool_LogLine( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			auto lease = StringBuilderPool::lease();
+			auto builder = lease.create();
+			writeLogLine( builder, log_record );
+			auto result = lease.buffer().toStringView();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	//----------------------------------------------
+	// JSON response
+	//----------------------------------------------
+
+	static void BM_StdString_JsonResponse( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			StdStringSink sink{ result };
+			writeJsonResponse( sink );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	static void BM_StringStream_JsonResponse( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::ostringstream oss;
+			writeJsonResponse( oss );
+			std::string result = oss.str();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+#if defined( __cpp_lib_format )
+	static void BM_StdFormat_JsonResponse( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			formatJsonResponse( result );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+#endif
+
+	static void BM_StringBuilderPool_JsonResponse( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			auto lease = StringBuilderPool::lease();
+			auto builder = lease.create();
+			writeJsonResponse( builder );
+			auto result = lease.buffer().toStringView();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	//----------------------------------------------
+	// CSV export
+	//----------------------------------------------
+
+	static void BM_StdString_CsvExport( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			StdStringSink sink{ result };
+			writeCsvExport( sink );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	static void BM_StringStream_CsvExport( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::ostringstream oss;
+			writeCsvExport( oss );
+			std::string result = oss.str();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+#if defined( __cpp_lib_format )
+	static void BM_StdFormat_CsvExport( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			formatCsvExport( result );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+#endif
+
+	static void BM_StringBuilderPool_CsvExport( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			auto lease = StringBuilderPool::lease();
+			auto builder = lease.create();
+			writeCsvExport( builder );
+			auto result = lease.buffer().toStringView();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	//----------------------------------------------
+	// HTTP response headers
+	//----------------------------------------------
+
+	static void BM_StdString_HttpHeaders( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			StdStringSink sink{ result };
+			writeHttpHeaders( sink );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	static void BM_StringStream_HttpHeaders( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::ostringstream oss;
+			writeHttpHeaders( oss );
+			std::string result = oss.str();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+#if defined( __cpp_lib_format )
+	static void BM_StdFormat_HttpHeaders( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			std::string result;
+			formatHttpHeaders( result );
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+#endif
+
+	static void BM_StringBuilderPool_HttpHeaders( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			auto lease = StringBuilderPool::lease();
+			auto builder = lease.create();
+			writeHttpHeaders( builder );
+			auto result = lease.buffer().toStringView();
+			::benchmark::DoNotOptimize( result );
+		}
+	}
+
+	//----------------------------------------------
+	// Metric names
+	//----------------------------------------------
+
+	static void BM_StdString_MetricNames( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			for ( const auto& id : metric_ids )
+			{
+				std::string result;
+				StdStringSink sink{ result };
+				writeMetricName( sink, id );
+				::benchmark::DoNotOptimize( result );
+			}
+		}
+	}
+
+	static void BM_StringStream_MetricNames( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			for ( const auto& id : metric_ids )
+			{
+				std::ostringstream oss;
+				writeMetricName( oss, id );
+				std::string result = oss.str();
+				::benchmark::DoNotOptimize( result );
+			}
+		}
+	}
+
+#if defined( __cpp_lib_format )
+	static void BM_StdFormat_MetricNames( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			for ( const auto& id : metric_ids )
+			{
+				std::string result;
+				formatMetricName( result, id );
+				::benchmark::DoNotOptimize( result );
+			}
+		}
+	}
+#endif
+
+	static void BM_StringBuilderPool_MetricNames( ::benchmark::State& state )
+	{
+		BenchmarkCounters counters{ state };
+
+		for ( auto _ : state )
+		{
+			for ( const auto& id : metric_ids )
+			{
+				auto lease = StringBuilderPool::lease();
+				auto builder = lease.create();
+				writeMetricName( builder, id );
+				auto result = lease.buffer().toStringView();
+				::benchmark::DoNotOptimize( result );
+			}
+		}
+	}
+} // namespace nfx::string::benchmark
+
+//=====================================================================
+// Benchmarks registration
+//=====================================================================
+
+//----------------------------------------------
+// Structured log line
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_LogLine )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringStream_LogLine )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+#if defined( __cpp_lib_format )
+BENCHMARK( nfx::string::benchmark::BM_StdFormat_LogLine )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+#endif
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_LogLine )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// JSON response
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_JsonResponse )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringStream_JsonResponse )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+#if defined( __cpp_lib_format )
+BENCHMARK( nfx::string::benchmark::BM_StdFormat_JsonResponse )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+#endif
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_JsonResponse )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// CSV export
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_CsvExport )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringStream_CsvExport )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+#if defined( __cpp_lib_format )
+BENCHMARK( nfx::string::benchmark::BM_StdFormat_CsvExport )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+#endif
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_CsvExport )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// HTTP response headers
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_HttpHeaders )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringStream_HttpHeaders )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+#if defined( __cpp_lib_format )
+BENCHMARK( nfx::string::benchmark::BM_StdFormat_HttpHeaders )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+#endif
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_HttpHeaders )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+//----------------------------------------------
+// Metric names
+//----------------------------------------------
+
+BENCHMARK( nfx::string::benchmark::BM_StdString_MetricNames )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK( nfx::string::benchmark::BM_StringStream_MetricNames )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+#if defined( __cpp_lib_format )
+BENCHMARK( nfx::string::benchmark::BM_StdFormat_MetricNames )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+#endif
+
+BENCHMARK( nfx::string::benchmark::BM_StringBuilderPool_MetricNames )
+	->MinTime( 1.0 )
+	->Unit( benchmark::kNanosecond );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,206 @@
+/**
+ * @file BenchmarkCounters.h
+ * @brief Optional hardware performance counters and allocation counts for benchmarks
+ * @details Construct a BenchmarkCounters right before the benchmark loop; when it goes out of scope
+ *          it adds per-iteration counters to the benchmark state:
+ *          - cycles, instructions, cache-misses, branch-misses (Linux perf_event_open)
+ *          - allocs (global operator new calls, from CountingAllocator.cpp)
+ *
+ *          Collection is compiled in only with NFX_STRINGBUILDERPOOL_BENCHMARK_COUNTERS. Hardware
+ *          counters are skipped silently when perf events are unavailable (non-Linux, containers,
+ *          perf_event_paranoid), leaving the allocation count.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+#if defined( NFX_STRINGBUILDERPOOL_BENCHMARK_COUNTERS ) && defined( __linux__ )
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace nfx::string::benchmark
+{
+#if defined( NFX_STRINGBUILDERPOOL_BENCHMARK_COUNTERS )
+
+	/**
+	 * @brief Gets number of global operator new calls so far
+	 * @return Allocation count, defined in CountingAllocator.cpp
+	 */
+	uint64_t allocationCount() noexcept;
+
+#	if defined( __linux__ )
+
+	//=====================================================================
+	// PerfEventGroup class
+	//=====================================================================
+
+	/** @brief RAII group of user-space hardware counters for the calling thread */
+	class PerfEventGroup final
+	{
+	public:
+		/** @brief Number of counters in the group */
+		static constexpr size_t COUNTER_COUNT = 4;
+
+		/** @brief Counter names, in group order */
+		static constexpr std::array<const char*, COUNTER_COUNT> NAMES{
+			"cycles", "instructions", "cache-misses", "branch-misses" };
+
+		PerfEventGroup()
+		{
+			constexpr std::array<uint64_t, COUNTER_COUNT> configs{
+				PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+			for ( size_t i = 0; i < COUNTER_COUNT; ++i )
+			{
+				perf_event_attr attributes{};
+				attributes.type = PERF_TYPE_HARDWARE;
+				attributes.size = sizeof( attributes );
+				attributes.config = configs[i];
+				attributes.disabled = i == 0 ? 1 : 0;
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+				attributes.read_format = PERF_FORMAT_GROUP;
+
+				const int groupFd = i == 0 ? -1 : m_fds[0];
+				m_fds[i] = static_cast<int>( ::syscall( SYS_perf_event_open, &attributes, 0, -1, groupFd, 0 ) );
+				if ( m_fds[i] < 0 )
+				{
+					close();
+					return;
+				}
+			}
+		}
+
+		~PerfEventGroup()
+		{
+			close();
+		}
+
+		PerfEventGroup( const PerfEventGroup& ) = delete;
+		PerfEventGroup& operator=( const PerfEventGroup& ) = delete;
+
+		/** @brief true if every counter of the group could be opened */
+		bool isOpen() const noexcept
+		{
+			return m_fds[0] >= 0;
+		}
+
+		void start() noexcept
+		{
+			::ioctl( m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+			::ioctl( m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+		}
+
+		/**
+		 * @brief Stops counting and reads the counters
+		 * @param values Receives the counter values, in NAMES order
+		 * @return true if the counters were read
+		 */
+		bool stop( std::array<uint64_t, COUNTER_COUNT>& values ) noexcept
+		{
+			::ioctl( m_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+
+			// PERF_FORMAT_GROUP layout: counter count followed by the values
+			std::array<uint64_t, COUNTER_COUNT + 1> buffer{};
+			if ( ::read( m_fds[0], buffer.data(), sizeof( buffer ) ) != static_cast<ssize_t>( sizeof( buffer ) ) )
+			{
+				return false;
+			}
+			for ( size_t i = 0; i < COUNTER_COUNT; ++i )
+			{
+				values[i] = buffer[i + 1];
+			}
+
+			return true;
+		}
+
+	private:
+		void close() noexcept
+		{
+			for ( auto& fd : m_fds )
+			{
+				if ( fd >= 0 )
+				{
+					::close( fd );
+				}
+				fd = -1;
+			}
+		}
+
+		std::array<int, COUNTER_COUNT> m_fds{ -1, -1, -1, -1 };
+	};
+
+#	endif
+
+	//=====================================================================
+	// BenchmarkCounters class
+	//=====================================================================
+
+	/** @brief Scope guard reporting hardware counters and allocations per iteration */
+	class BenchmarkCounters final
+	{
+	public:
+		explicit BenchmarkCounters( ::benchmark::State& state )
+			: m_state{ state },
+			  m_allocationsAtStart{ allocationCount() }
+		{
+#	if defined( __linux__ )
+			if ( m_perf.isOpen() )
+			{
+				m_perf.start();
+			}
+#	endif
+		}
+
+		~BenchmarkCounters()
+		{
+			const auto perIteration = ::benchmark::Counter::kAvgIterations;
+
+#	if defined( __linux__ )
+			std::array<uint64_t, PerfEventGroup::COUNTER_COUNT> values{};
+			if ( m_perf.isOpen() && m_perf.stop( values ) )
+			{
+				for ( size_t i = 0; i < values.size(); ++i )
+				{
+					m_state.counters[PerfEventGroup::NAMES[i]] =
+						::benchmark::Counter( static_cast<double>( values[i] ), perIteration );
+				}
+			}
+#	endif
+
+			m_state.counters["allocs"] =
+				::benchmark::Counter( static_cast<double>( allocationCount() - m_allocationsAtStart ), perIteration );
+		}
+
+		BenchmarkCounters( const BenchmarkCounters& ) = delete;
+		BenchmarkCounters& operator=( const BenchmarkCounters& ) = delete;
+
+	private:
+		::benchmark::State& m_state;
+		const uint64_t m_allocationsAtStart;
+#	if defined( __linux__ )
+		PerfEventGroup m_perf;
+#	endif
+	};
+
+#else
+
+	/** @brief No-op when benchmark counters are not compiled in */
+	class BenchmarkCounters final
+	{
+	public:
+		explicit BenchmarkCounters( ::benchmark::State& ) noexcept
+		{
+		}
+	};
+
+#endif
+} // namespace nfx::string::benchmark
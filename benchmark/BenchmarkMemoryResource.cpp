@@ -0,0 +1,115 @@
+/**
+ * @file BenchmarkMemoryResource.cpp
+ * @brief Selects the memory resource backing pooled buffer storage in benchmark executables
+ * @details Linked into every benchmark executable. Before main() runs, the resource named by the
+ *          NFX_BENCHMARK_MEMORY_RESOURCE environment variable is installed with
+ *          StringBuilderPool::setMemoryResource():
+ *          - new                  Default allocator (unset variable)
+ *          - synchronized-pool    std::pmr::synchronized_pool_resource
+ *          - unsynchronized-pool  std::pmr::unsynchronized_pool_resource (single-threaded benchmarks only)
+ *          - monotonic            std::pmr::monotonic_buffer_resource (single-threaded benchmarks only,
+ *                                 never frees until exit)
+ *
+ *          Executables built with NFX_BENCHMARK_MULTITHREADED drive the pool from several threads
+ *          and exit with an error when asked for one of the single-threaded resources.
+ *
+ *          The underlying C allocator is chosen at build time: executables with a _jemalloc or
+ *          _mimalloc suffix link that allocator in place of the C library's malloc. Both names
+ *          are added to the Google Benchmark context.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include <nfx/string/StringBuilderPool.h>
+
+#if !defined( NFX_BENCHMARK_ALLOCATOR )
+#	define NFX_BENCHMARK_ALLOCATOR "system"
+#endif
+
+namespace nfx::string::benchmark
+{
+	namespace
+	{
+		//=====================================================================
+		// Memory resource selection
+		//=====================================================================
+
+		/** @brief True if this executable uses the pool from several threads */
+#if defined( NFX_BENCHMARK_MULTITHREADED )
+		constexpr bool MULTITHREADED = true;
+#else
+		constexpr bool MULTITHREADED = false;
+#endif
+
+		/**
+		 * @brief Owns the candidate resources and installs the selected one
+		 * @details Constructed during static initialization, before the pool singleton, so the
+		 *          resources outlive every pooled buffer.
+		 */
+		class MemoryResourceSelection final
+		{
+		public:
+			MemoryResourceSelection()
+			{
+				const char* variable = std::getenv( "NFX_BENCHMARK_MEMORY_RESOURCE" );
+				const std::string_view name = variable != nullptr && *variable != '\0' ? variable : "new";
+
+				std::pmr::memory_resource* resource = nullptr;
+				bool threadSafe = true;
+				if ( name == "synchronized-pool" )
+				{
+					resource = &m_synchronizedPool;
+				}
+				else if ( name == "unsynchronized-pool" )
+				{
+					resource = &m_unsynchronizedPool;
+					threadSafe = false;
+				}
+				else if ( name == "monotonic" )
+				{
+					resource = &m_monotonic;
+					threadSafe = false;
+				}
+				else if ( name != "new" )
+				{
+					std::fprintf( stderr, "Unknown NFX_BENCHMARK_MEMORY_RESOURCE: %s "
+										  "(new, synchronized-pool, unsynchronized-pool, monotonic)\n",
+						variable );
+					std::exit( EXIT_FAILURE );
+				}
+
+				if ( MULTITHREADED && !threadSafe )
+				{
+					std::fprintf( stderr, "NFX_BENCHMARK_MEMORY_RESOURCE=%s is not thread-safe and this benchmark "
+										  "uses several threads (new, synchronized-pool)\n",
+						variable );
+					std::exit( EXIT_FAILURE );
+				}
+
+				StringBuilderPool::setMemoryResource( resource );
+				::benchmark::AddCustomContext( "memory_resource", std::string{ name } );
+				::benchmark::AddCustomContext( "allocator", NFX_BENCHMARK_ALLOCATOR );
+			}
+
+			~MemoryResourceSelection()
+			{
+				StringBuilderPool::setMemoryResource( nullptr );
+			}
+
+			MemoryResourceSelection( const MemoryResourceSelection& ) = delete;
+			MemoryResourceSelection& operator=( const MemoryResourceSelection& ) = delete;
+
+		private:
+			std::pmr::synchronized_pool_resource m_synchronizedPool;
+			std::pmr::unsynchronized_pool_resource m_unsynchronizedPool;
+			std::pmr::monotonic_buffer_resource m_monotonic;
+		};
+
+		const MemoryResourceSelection g_memoryResourceSelection;
+	} // namespace
+} // namespace nfx::string::benchmark
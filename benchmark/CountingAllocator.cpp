@@ -0,0 +1,154 @@
+/**
+ * @file CountingAllocator.cpp
+ * @brief Replacement global operator new/delete counting allocations for benchmarks
+ * @details Linked into benchmark executables when NFX_STRINGBUILDERPOOL_BENCHMARK_COUNTERS is enabled.
+ *          Every replaceable allocation form is forwarded to the C allocator after a relaxed
+ *          increment, so BenchmarkCounters can report allocations per iteration.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "BenchmarkCounters.h"
+
+namespace
+{
+	/** @brief Number of global operator new calls */
+	std::atomic<uint64_t> g_allocationCount{ 0 };
+
+	void* allocate( std::size_t size )
+	{
+		g_allocationCount.fetch_add( 1, std::memory_order_relaxed );
+		if ( void* pointer = std::malloc( size == 0 ? 1 : size ) )
+		{
+			return pointer;
+		}
+
+		throw std::bad_alloc{};
+	}
+
+	void* allocateAligned( std::size_t size, std::align_val_t alignment )
+	{
+		g_allocationCount.fetch_add( 1, std::memory_order_relaxed );
+		const auto align = static_cast<std::size_t>( alignment );
+		const std::size_t rounded = ( ( size == 0 ? 1 : size ) + align - 1 ) & ~( align - 1 );
+#if defined( _WIN32 )
+		void* pointer = ::_aligned_malloc( rounded, align );
+#else
+		void* pointer = std::aligned_alloc( align, rounded );
+#endif
+		if ( pointer )
+		{
+			return pointer;
+		}
+
+		throw std::bad_alloc{};
+	}
+
+	void deallocateAligned( void* pointer ) noexcept
+	{
+#if defined( _WIN32 )
+		::_aligned_free( pointer );
+#else
+		std::free( pointer );
+#endif
+	}
+} // namespace
+
+namespace nfx::string::benchmark
+{
+	uint64_t allocationCount() noexcept
+	{
+		return g_allocationCount.load( std::memory_order_relaxed );
+	}
+} // namespace nfx::string::benchmark
+
+//=====================================================================
+// Replaceable allocation functions
+//=====================================================================
+
+void* operator new( std::size_t size )
+{
+	return allocate( size );
+}
+
+void* operator new[]( std::size_t size )
+{
+	return allocate( size );
+}
+
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+	try
+	{
+		return allocate( size );
+	}
+	catch ( const std::bad_alloc& )
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[]( std::size_t size, const std::nothrow_t& ) noexcept
+{
+	try
+	{
+		return allocate( size );
+	}
+	catch ( const std::bad_alloc& )
+	{
+		return nullptr;
+	}
+}
+
+void* operator new( std::size_t size, std::align_val_t alignment )
+{
+	return allocateAligned( size, alignment );
+}
+
+void* operator new[]( std::size_t size, std::align_val_t alignment )
+{
+	return allocateAligned( size, alignment );
+}
+
+void operator delete( void* pointer ) noexcept
+{
+	std::free( pointer );
+}
+
+void operator delete[]( void* pointer ) noexcept
+{
+	std::free( pointer );
+}
+
+void operator delete( void* pointer, std::size_t ) noexcept
+{
+	std::free( pointer );
+}
+
+void operator delete[]( void* pointer, std::size_t ) noexcept
+{
+	std::free( pointer );
+}
+
+void operator delete( void* pointer, std::align_val_t ) noexcept
+{
+	deallocateAligned( pointer );
+}
+
+void operator delete[]( void* pointer, std::align_val_t ) noexcept
+{
+	deallocateAligned( pointer );
+}
+
+void operator delete( void* pointer, std::size_t, std::align_val_t ) noexcept
+{
+	deallocateAligned( pointer );
+}
+
+void operator delete[]( void* pointer, std::size_t, std::align_val_t ) noexcept
+{
+	deallocateAligned( pointer );
+}
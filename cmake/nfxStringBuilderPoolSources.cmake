@@ -17,12 +17,42 @@ list(APPEND PUBLIC_HEADERS
 )
 list(APPEND PRIVATE_HEADERS
 	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/DynamicStringBufferPool.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/LeaseAttribution.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/LeaseTracker.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/PoolFeatures.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/PoolHistograms.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/PoolTraceFormat.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/PoolTraceRecorder.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/Probes.h
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/StringInternTable.h
 )
 list(APPEND PRIVATE_SOURCES
 	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/DynamicStringBufferPool.cpp
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/LeaseAttribution.cpp
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/LeaseTracker.cpp
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/OpenMetricsExporter.cpp
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/PoolHistograms.cpp
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/PoolTraceRecorder.cpp
 	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/StringBuilderPool.cpp
+	${NFX_STRINGBUILDERPOOL_SOURCE_DIR}/StringInternTable.cpp
 )
 
+#----------------------------------------------
+# Static tracepoints
+#----------------------------------------------
+
+set(NFX_STRINGBUILDERPOOL_HAS_USDT OFF)
+if(NFX_STRINGBUILDERPOOL_ENABLE_USDT)
+	include(CheckIncludeFileCXX)
+	check_include_file_cxx("sys/sdt.h" NFX_STRINGBUILDERPOOL_HAS_SDT_HEADER)
+	if(NFX_STRINGBUILDERPOOL_HAS_SDT_HEADER)
+		set(NFX_STRINGBUILDERPOOL_HAS_USDT ON)
+		message(STATUS "USDT probes enabled")
+	else()
+		message(WARNING "NFX_STRINGBUILDERPOOL_ENABLE_USDT is ON but sys/sdt.h was not found (install systemtap-sdt-dev) - probes disabled")
+	endif()
+endif()
+
 #----------------------------------------------
 # Library definition
 #----------------------------------------------
@@ -77,6 +107,11 @@ function(configure_target target_name)
 			${NFX_STRINGBUILDERPOOL_SOURCE_DIR}
 	)
 
+	# --- Static tracepoints ---
+	if(NFX_STRINGBUILDERPOOL_HAS_USDT)
+		target_compile_definitions(${target_name} PRIVATE NFX_STRINGBUILDERPOOL_USDT)
+	endif()
+
 	# --- Properties ---
 	set_target_properties(${target_name} PROPERTIES
 		CXX_STANDARD 20
@@ -129,6 +129,15 @@ namespace nfx::string
 		m_buffer.resize( newSize );
 	}
 
+	//----------------------------------------------
+	// String views
+	//----------------------------------------------
+
+	inline std::string_view StringBuilder::view( size_t offset, size_t count ) const
+	{
+		return m_buffer.view( offset, count );
+	}
+
 	//----------------------------------------------
 	// Iterator interface
 	//----------------------------------------------
@@ -193,6 +202,175 @@ namespace nfx::string
 		m_current = std::prev( m_data );
 	}
 
+	//=====================================================================
+	// Heterogeneous lookup keys
+	//=====================================================================
+
+	//----------------------------------------------
+	// StringKey class
+	//----------------------------------------------
+
+	inline StringKey::StringKey( std::string_view str ) noexcept
+		: m_view{ str },
+		  m_hash{ DynamicStringBuffer::hashOf( str ) }
+	{
+	}
+
+	inline StringKey::StringKey( std::string_view str, uint64_t hash ) noexcept
+		: m_view{ str },
+		  m_hash{ hash }
+	{
+	}
+
+	inline StringKey::StringKey( const DynamicStringBuffer& buffer ) noexcept
+		: m_view{ buffer.toStringView() },
+		  m_hash{ buffer.hash() }
+	{
+	}
+
+	inline std::string_view StringKey::view() const noexcept
+	{
+		return m_view;
+	}
+
+	inline uint64_t StringKey::hash() const noexcept
+	{
+		return m_hash;
+	}
+
+	inline StringKey::operator std::string_view() const noexcept
+	{
+		return m_view;
+	}
+
+	//----------------------------------------------
+	// StringKeyHash struct
+	//----------------------------------------------
+
+	inline size_t StringKeyHash::operator()( std::string_view str ) const noexcept
+	{
+		return static_cast<size_t>( DynamicStringBuffer::hashOf( str ) );
+	}
+
+	inline size_t StringKeyHash::operator()( const std::string& str ) const noexcept
+	{
+		return static_cast<size_t>( DynamicStringBuffer::hashOf( str ) );
+	}
+
+	inline size_t StringKeyHash::operator()( const char* str ) const noexcept
+	{
+		return static_cast<size_t>( DynamicStringBuffer::hashOf( str ) );
+	}
+
+	inline size_t StringKeyHash::operator()( const StringKey& key ) const noexcept
+	{
+		return static_cast<size_t>( key.hash() );
+	}
+
+	//----------------------------------------------
+	// StringKeyEqual struct
+	//----------------------------------------------
+
+	inline bool StringKeyEqual::operator()( std::string_view lhs, std::string_view rhs ) const noexcept
+	{
+		return lhs == rhs;
+	}
+
+	//=====================================================================
+	// PooledString class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Construction
+	//----------------------------------------------
+
+	inline PooledString::PooledString( DynamicStringBuffer* buffer, const void* origin ) noexcept
+		: m_buffer{ buffer },
+		  m_origin{ origin }
+	{
+	}
+
+	inline PooledString::PooledString() noexcept
+		: m_buffer{ nullptr },
+		  m_origin{ nullptr }
+	{
+	}
+
+	inline PooledString::PooledString( PooledString&& other ) noexcept
+		: m_buffer{ std::exchange( other.m_buffer, nullptr ) },
+		  m_origin{ other.m_origin }
+	{
+	}
+
+	//----------------------------------------------
+	// Assignment
+	//----------------------------------------------
+
+	inline PooledString& PooledString::operator=( PooledString&& other ) noexcept
+	{
+		if ( this != &other )
+		{
+			dispose();
+			m_buffer = std::exchange( other.m_buffer, nullptr );
+			m_origin = other.m_origin;
+		}
+
+		return *this;
+	}
+
+	//----------------------------------------------
+	// Accessors
+	//----------------------------------------------
+
+	inline size_t PooledString::size() const noexcept
+	{
+		return m_buffer ? m_buffer->size() : 0;
+	}
+
+	inline bool PooledString::isEmpty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	inline const char* PooledString::data() const noexcept
+	{
+		return m_buffer ? m_buffer->data() : "";
+	}
+
+	inline std::string_view PooledString::toStringView() const noexcept
+	{
+		return m_buffer ? m_buffer->toStringView() : std::string_view{};
+	}
+
+	inline std::string PooledString::toString() const
+	{
+		return std::string{ toStringView() };
+	}
+
+	inline PooledString::operator std::string_view() const noexcept
+	{
+		return toStringView();
+	}
+
+	inline bool PooledString::operator==( std::string_view other ) const noexcept
+	{
+		return toStringView() == other;
+	}
+
+	//----------------------------------------------
+	// Iterator interface
+	//----------------------------------------------
+
+	inline PooledString::const_iterator PooledString::begin() const noexcept
+	{
+		return data();
+	}
+
+	inline PooledString::const_iterator PooledString::end() const noexcept
+	{
+		return data() + size();
+	}
+
 	//=====================================================================
 	// StringBuilderLease class
 	//=====================================================================
@@ -201,15 +379,17 @@ namespace nfx::string
 	// Construction
 	//----------------------------------------------
 
-	inline StringBuilderLease::StringBuilderLease( DynamicStringBuffer* buffer )
+	inline StringBuilderLease::StringBuilderLease( DynamicStringBuffer* buffer, const void* origin )
 		: m_buffer{ buffer },
-		  m_valid{ true }
+		  m_valid{ true },
+		  m_origin{ origin }
 	{
 	}
 
 	inline StringBuilderLease::StringBuilderLease( StringBuilderLease&& other ) noexcept
 		: m_buffer{ std::exchange( other.m_buffer, nullptr ) },
-		  m_valid{ std::exchange( other.m_valid, false ) }
+		  m_valid{ std::exchange( other.m_valid, false ) },
+		  m_origin{ other.m_origin }
 	{
 	}
 
@@ -224,6 +404,7 @@ namespace nfx::string
 			dispose();
 			m_buffer = std::exchange( other.m_buffer, nullptr );
 			m_valid = std::exchange( other.m_valid, false );
+			m_origin = other.m_origin;
 		}
 
 		return *this;
@@ -262,4 +443,26 @@ namespace nfx::string
 
 		return m_buffer->toString();
 	}
+
+	inline PooledString StringBuilderLease::take()
+	{
+		if ( !m_valid )
+		{
+			throwInvalidOperation();
+		}
+
+		m_valid = false;
+
+		return PooledString{ std::exchange( m_buffer, nullptr ), m_origin };
+	}
+
+	inline StringKey StringBuilderLease::key() const
+	{
+		if ( !m_valid )
+		{
+			throwInvalidOperation();
+		}
+
+		return StringKey{ *m_buffer };
+	}
 } // namespace nfx::string
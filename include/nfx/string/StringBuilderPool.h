@@ -42,6 +42,7 @@
  * │  │  │  create()  → StringBuilder                  │    │    │ ← Fluent interface
  * │  │  │  buffer()  → DynamicStringBuffer            │    │    │ ← Direct access
  * │  │  │  toString() → std::string                   │    │    │ ← Conversion
+ * │  │  │  take()    → PooledString                   │    │    │ ← Zero-copy result
  * │  │  └─────────────────────────────────────────────┘    │    │
  * │  └─────────────────────────────────────────────────────┘    │
  * │                                                             │
@@ -78,10 +79,15 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
-#include <memory>
+#include <memory_resource>
+#include <source_location>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 namespace nfx::string
 {
@@ -95,12 +101,16 @@ namespace nfx::string
 	 *          Features automatic capacity management, iterator support, and zero-copy
 	 *          string_view access. Designed for internal use by StringBuilderPool.
 	 *
+	 * @note The object keeps a single active data pointer, so every data access is branch-free.
+	 *       The pointer, size, capacity and hash fill the first 32 bytes, and the 32-byte alignment
+	 *       keeps them on one cache line without padding the object to a whole line.
+	 *
 	 * @warning Not thread-safe - external synchronization required for concurrent access.
 	 *
 	 * @see StringBuilderPool for the recommended high-level interface
 	 * @see StringBuilder for a more convenient wrapper around this buffer
 	 */
-	class DynamicStringBuffer final
+	class alignas( 32 ) DynamicStringBuffer final
 	{
 		friend class DynamicStringBufferPool;
 
@@ -137,7 +147,7 @@ namespace nfx::string
 		//----------------------------------------------
 
 		/** @brief Destructor */
-		~DynamicStringBuffer() = default;
+		~DynamicStringBuffer();
 
 		//----------------------------------------------
 		// Assignment
@@ -210,6 +220,34 @@ namespace nfx::string
 		 */
 		void resize( size_t newSize );
 
+		/**
+		 * @brief Switches the buffer to a reserved virtual address range
+		 * @param maxCapacity Size of the address range to reserve in bytes
+		 * @details Reserves maxCapacity bytes of address space up front and commits pages on demand
+		 *          as the buffer grows, so growth never reallocates or copies and data() stays stable
+		 *          for the lifetime of the reservation. Existing content is preserved.
+		 * @throws std::length_error if maxCapacity is smaller than the current size
+		 * @throws std::bad_alloc if the address range cannot be reserved or committed
+		 * @note Growing past maxCapacity throws std::length_error
+		 */
+		void reserveAddressSpace( size_t maxCapacity );
+
+		/**
+		 * @brief Release unused capacity
+		 * @details Moves content back into the stack buffer when it fits, otherwise reallocates the
+		 *          heap block down to the content size. In reservation mode the unused pages are
+		 *          decommitted instead, so data() stays stable.
+		 * @throws std::bad_alloc if the smaller heap block cannot be allocated
+		 */
+		void shrinkToFit();
+
+		/**
+		 * @brief Get size of the reserved virtual address range
+		 * @return Reserved address range in bytes, or 0 if the buffer is not in reservation mode
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] size_t reservedCapacity() const noexcept;
+
 		//----------------------------------------------
 		// Data access
 		//----------------------------------------------
@@ -301,6 +339,59 @@ namespace nfx::string
 		 */
 		[[nodiscard]] std::string_view toStringView() const noexcept;
 
+		/**
+		 * @brief Get string_view of a range of buffer content
+		 * @param offset Position of the first character
+		 * @param count Number of characters, clamped to the end of the content
+		 * @return String view referencing buffer data
+		 * @details In reservation mode (see reserveAddressSpace()) the view stays valid across
+		 *          later appends, which allows zero-copy tokenization while building
+		 * @throws std::out_of_range if offset > size()
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] std::string_view view( size_t offset, size_t count ) const;
+
+		//----------------------------------------------
+		// Content hashing
+		//----------------------------------------------
+
+		/**
+		 * @brief Enable incremental hashing of buffer content
+		 * @details Hashes the current content once, then folds every append() and push_back() into
+		 *          the running hash so hash() is available without another pass over the buffer.
+		 *          Stays enabled until disabled, or until the buffer is returned to the pool.
+		 * @warning Writes through data(), operator[] or iterators bypass the running hash - call
+		 *          enableIncrementalHash() again after modifying content directly.
+		 */
+		void enableIncrementalHash() noexcept;
+
+		/** @brief Disable incremental hashing of buffer content */
+		void disableIncrementalHash() noexcept;
+
+		/**
+		 * @brief Check if incremental hashing is enabled
+		 * @return true if appends update the running hash, false otherwise
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] bool isIncrementalHashEnabled() const noexcept;
+
+		/**
+		 * @brief Get 64-bit hash of buffer content
+		 * @return Running hash when incremental hashing is enabled, otherwise computed on demand
+		 * @details Always equal to hashOf( toStringView() )
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] uint64_t hash() const noexcept;
+
+		/**
+		 * @brief Compute the hash function used by hash() for arbitrary content
+		 * @param str Content to hash
+		 * @return 64-bit hash of str, computed over 8-byte blocks
+		 * @details Use it to hash stored keys so they match buffers hashed incrementally
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] static uint64_t hashOf( std::string_view str ) noexcept;
+
 		//----------------------------------------------
 		// Iterator interface
 		//----------------------------------------------
@@ -357,15 +448,21 @@ namespace nfx::string
 		/** @brief Growth factor for heap allocation */
 		static constexpr auto GROWTH_FACTOR = 1.5;
 
+		/** @brief Alignment of heap storage (one cache line, suitable for SIMD loads) */
+		static constexpr size_t HEAP_ALIGNMENT = 64;
+
+		/** @brief Heap capacity from which storage comes from huge-page-advised mappings (Linux) */
+		static constexpr size_t HUGE_PAGE_THRESHOLD = 2 * 1024 * 1024;
+
 		//----------------------------------------------
 		// Private members
 		//----------------------------------------------
 
-		/** @brief Stack-allocated buffer for small strings */
-		alignas( char ) char m_stackBuffer[STACK_BUFFER_SIZE];
+		// Hot metadata is declared first so that the active data pointer, size, capacity and
+		// running hash occupy the object's first 32 bytes, which never straddle a cache line.
 
-		/** @brief Heap-allocated buffer for large strings */
-		std::unique_ptr<char[]> m_heapBuffer;
+		/** @brief Pointer to the active storage (m_stackBuffer or a heap block) */
+		char* m_data;
 
 		/** @brief Current size of data in buffer */
 		size_t m_size;
@@ -373,8 +470,35 @@ namespace nfx::string
 		/** @brief Current capacity of buffer */
 		size_t m_capacity;
 
-		/** @brief True if using heap buffer, false if using stack buffer */
-		bool m_onHeap;
+		/** @brief Running hash of the content, valid while m_hashEnabled is set */
+		uint64_t m_hash;
+
+		/** @brief True if appends update m_hash */
+		bool m_hashEnabled;
+
+		/** @brief Memory resource registry slot the heap block came from, 0 for the default allocator */
+		uint8_t m_resourceSlot;
+
+		/** @brief Stack-allocated buffer for small strings */
+		alignas( char ) char m_stackBuffer[STACK_BUFFER_SIZE];
+
+		// Cold per-lease bookkeeping fills the padding after the stack buffer and the tail of the
+		// object; sizeof( DynamicStringBuffer ) is pinned by a static_assert in StringBuilderPool.cpp.
+
+		/** @brief Call site slot of a sampled lease, 0 if the lease is not attributed */
+		uint32_t m_attributionSite;
+
+		/** @brief Size of the reserved address range, 0 unless in reservation mode */
+		size_t m_reservedCapacity;
+
+		/** @brief Steady-clock time the current lease started in nanoseconds, 0 if not sampled */
+		uint64_t m_leaseStart;
+
+		/** @brief Number of capacity growths during the current lease */
+		uint32_t m_growthCount;
+
+		/** @brief Bytes copied by reallocating growths during the current lease, saturating at UINT32_MAX */
+		uint32_t m_growthBytesCopied;
 
 		//----------------------------------------------
 		// Private methods
@@ -387,16 +511,40 @@ namespace nfx::string
 		void ensureCapacity( size_t needed_capacity );
 
 		/**
-		 * @brief Returns pointer to current buffer (stack or heap)
-		 * @return Pointer to active buffer
+		 * @brief Checks whether the active storage is a heap block
+		 * @return true if m_data points to heap storage, false if it points to m_stackBuffer
+		 */
+		bool isOnHeap() const noexcept;
+
+		/** @brief Releases heap storage or address range (if any) and points m_data back to m_stackBuffer */
+		void releaseHeapBuffer() noexcept;
+
+		/**
+		 * @brief Commits more pages of the reserved address range
+		 * @param neededCapacity Minimum required capacity, must not exceed m_reservedCapacity
+		 * @throws std::bad_alloc if the pages cannot be committed
+		 */
+		void commitAddressSpace( size_t neededCapacity );
+
+		/**
+		 * @brief Allocates cache-line-aligned heap storage
+		 * @param capacity Requested capacity in bytes, updated to the actual capacity of the block
+		 * @param resourceSlot Set to the registry slot of the memory resource that supplied the block
+		 * @return Pointer to the allocated storage
+		 * @details Uses the resource installed with StringBuilderPool::setMemoryResource() if any.
+		 *          Otherwise blocks of HUGE_PAGE_THRESHOLD bytes or more are rounded up to a 2 MB
+		 *          multiple and mapped with transparent huge pages advised where the platform supports it
+		 * @throws std::bad_alloc if memory allocation fails
 		 */
-		char* currentBuffer() noexcept;
+		static char* allocateHeapBuffer( size_t& capacity, uint8_t& resourceSlot );
 
 		/**
-		 * @brief Returns const pointer to current buffer (stack or heap)
-		 * @return Const pointer to active buffer
+		 * @brief Releases storage obtained from allocateHeapBuffer()
+		 * @param buffer Pointer returned by allocateHeapBuffer()
+		 * @param capacity Actual capacity reported by allocateHeapBuffer()
+		 * @param resourceSlot Registry slot reported by allocateHeapBuffer()
 		 */
-		const char* currentBuffer() const noexcept;
+		static void deallocateHeapBuffer( char* buffer, size_t capacity, uint8_t resourceSlot ) noexcept;
 	};
 
 	//=====================================================================
@@ -551,6 +699,20 @@ namespace nfx::string
 		 */
 		inline void resize( size_t newSize );
 
+		//----------------------------------------------
+		// String views
+		//----------------------------------------------
+
+		/**
+		 * @brief Returns string_view of a range of the built content
+		 * @param offset Position of the first character
+		 * @param count Number of characters, clamped to the end of the content
+		 * @return String view referencing buffer data
+		 * @details Views stay valid across later appends when the lease comes from StringBuilderPool::leaseStable()
+		 * @throws std::out_of_range if offset > length()
+		 */
+		inline std::string_view view( size_t offset, size_t count ) const;
+
 		//----------------------------------------------
 		// Iterator interface
 		//----------------------------------------------
@@ -671,6 +833,304 @@ namespace nfx::string
 		DynamicStringBuffer& m_buffer;
 	};
 
+	//=====================================================================
+	// Heterogeneous lookup keys
+	//=====================================================================
+
+	/**
+	 * @brief Non-owning lookup key pairing a string view with its precomputed hash
+	 * @details Lets a key built in a leased buffer probe unordered containers keyed by std::string
+	 *          without materializing a temporary string. Use with StringKeyHash and StringKeyEqual:
+	 *
+	 * @code
+	 * std::unordered_map<std::string, int, StringKeyHash, StringKeyEqual> map;
+	 * auto lease = StringBuilderPool::lease();
+	 * lease.create() << "user:" << id;
+	 * auto it = map.find( lease.key() ); // no allocation
+	 * @endcode
+	 *
+	 * @note The key views the source content - it must not outlive it or survive its modification.
+	 */
+	class StringKey final
+	{
+	public:
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+
+		/**
+		 * @brief Constructs key hashing the given content
+		 * @param str Content to use as key
+		 */
+		inline StringKey( std::string_view str ) noexcept;
+
+		/**
+		 * @brief Constructs key from content and its already computed hash
+		 * @param str Content to use as key
+		 * @param hash Value of DynamicStringBuffer::hashOf( str )
+		 */
+		inline StringKey( std::string_view str, uint64_t hash ) noexcept;
+
+		/**
+		 * @brief Constructs key from buffer content
+		 * @param buffer Buffer whose content is used as key
+		 * @details Reuses the running hash when incremental hashing is enabled on the buffer
+		 */
+		inline explicit StringKey( const DynamicStringBuffer& buffer ) noexcept;
+
+		//----------------------------------------------
+		// Accessors
+		//----------------------------------------------
+
+		/**
+		 * @brief Gets key content
+		 * @return View of the key content
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline std::string_view view() const noexcept;
+
+		/**
+		 * @brief Gets precomputed hash of the key content
+		 * @return 64-bit hash, equal to DynamicStringBuffer::hashOf( view() )
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline uint64_t hash() const noexcept;
+
+		/**
+		 * @brief Implicit conversion to string_view
+		 * @return View of the key content
+		 */
+		inline operator std::string_view() const noexcept;
+
+	private:
+		//----------------------------------------------
+		// Private member variables
+		//----------------------------------------------
+
+		/** @brief Key content */
+		std::string_view m_view;
+
+		/** @brief Precomputed hash of m_view */
+		uint64_t m_hash;
+	};
+
+	/**
+	 * @brief Transparent hash functor for unordered containers probed with StringKey
+	 * @details Hashes std::string, std::string_view and C strings with DynamicStringBuffer::hashOf(),
+	 *          and returns the precomputed hash of StringKey instances without touching the content.
+	 */
+	struct StringKeyHash final
+	{
+		/** @brief Enables heterogeneous lookup */
+		using is_transparent = void;
+
+		/**
+		 * @brief Hashes string content
+		 * @param str Content to hash
+		 * @return Hash value
+		 */
+		inline size_t operator()( std::string_view str ) const noexcept;
+
+		/**
+		 * @brief Hashes std::string content
+		 * @param str Content to hash
+		 * @return Hash value
+		 */
+		inline size_t operator()( const std::string& str ) const noexcept;
+
+		/**
+		 * @brief Hashes null-terminated string content
+		 * @param str Content to hash
+		 * @return Hash value
+		 */
+		inline size_t operator()( const char* str ) const noexcept;
+
+		/**
+		 * @brief Returns precomputed key hash
+		 * @param key Key to hash
+		 * @return Hash value
+		 */
+		inline size_t operator()( const StringKey& key ) const noexcept;
+	};
+
+	/**
+	 * @brief Transparent equality functor for unordered containers probed with StringKey
+	 * @details Compares any mix of std::string, std::string_view, C strings and StringKey by content.
+	 */
+	struct StringKeyEqual final
+	{
+		/** @brief Enables heterogeneous lookup */
+		using is_transparent = void;
+
+		/**
+		 * @brief Compares content of two strings
+		 * @param lhs First string
+		 * @param rhs Second string
+		 * @return true if both contain the same characters
+		 */
+		inline bool operator()( std::string_view lhs, std::string_view rhs ) const noexcept;
+	};
+
+	//=====================================================================
+	// PooledString class
+	//=====================================================================
+
+	/**
+	 * @brief Move-only string result that keeps its characters in a pooled buffer
+	 * @details Produced by StringBuilderLease::take(), which hands the leased DynamicStringBuffer
+	 *          over instead of copying it into a std::string. Content up to the buffer's stack
+	 *          capacity (256 bytes) lives inline in the pooled object, larger content in the
+	 *          buffer's pooled heap block, so short-lived results never touch malloc. The buffer
+	 *          goes back to the pool when the PooledString is destroyed.
+	 *
+	 * @note The content is not null-terminated - use toStringView() or toString().
+	 *
+	 * @warning Not thread-safe - external synchronization required for concurrent access.
+	 *
+	 * @see StringBuilderLease::take() for obtaining PooledString instances
+	 */
+	class PooledString final
+	{
+		friend class StringBuilderLease;
+
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+	private:
+		/**
+		 * @brief Constructs PooledString taking ownership of a pooled buffer
+		 * @param buffer Buffer moved out of a lease
+		 * @param origin Thread that leased the buffer, nullptr if origin is not tracked
+		 */
+		inline PooledString( DynamicStringBuffer* buffer, const void* origin ) noexcept;
+
+	public:
+		/** @brief Default constructor - creates an empty string that owns no buffer */
+		inline PooledString() noexcept;
+
+		/** @brief Copy constructor */
+		PooledString( const PooledString& ) = delete;
+
+		/**
+		 * @brief Move constructor
+		 * @param other The PooledString to move from
+		 */
+		inline PooledString( PooledString&& other ) noexcept;
+
+		//----------------------------------------------
+		// Destruction
+		//----------------------------------------------
+
+		/** @brief Destructor - returns the buffer to the pool */
+		~PooledString();
+
+		//----------------------------------------------
+		// Assignment
+		//----------------------------------------------
+
+		/** @brief Copy assignment operator */
+		PooledString& operator=( const PooledString& ) = delete;
+
+		/**
+		 * @brief Move assignment operator
+		 * @param other The PooledString to move from
+		 * @return Reference to this PooledString after assignment
+		 */
+		inline PooledString& operator=( PooledString&& other ) noexcept;
+
+		//----------------------------------------------
+		// Accessors
+		//----------------------------------------------
+
+		/**
+		 * @brief Returns the number of characters
+		 * @return Size of the string in bytes
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline size_t size() const noexcept;
+
+		/**
+		 * @brief Checks if the string is empty
+		 * @return true if the string contains no characters, false otherwise
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline bool isEmpty() const noexcept;
+
+		/**
+		 * @brief Returns pointer to the characters
+		 * @return Pointer to the first character (not null-terminated)
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline const char* data() const noexcept;
+
+		/**
+		 * @brief Returns string_view of the content
+		 * @return String view valid for the lifetime of this PooledString
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline std::string_view toStringView() const noexcept;
+
+		/**
+		 * @brief Copies the content into a std::string
+		 * @return String copy of the content
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline std::string toString() const;
+
+		/**
+		 * @brief Implicit conversion to string_view
+		 * @return String view valid for the lifetime of this PooledString
+		 */
+		inline operator std::string_view() const noexcept;
+
+		/**
+		 * @brief Compares content with a string_view
+		 * @param other String view to compare with
+		 * @return true if both contain the same characters
+		 */
+		inline bool operator==( std::string_view other ) const noexcept;
+
+		//----------------------------------------------
+		// Iterator interface
+		//----------------------------------------------
+
+		/** @brief Character type for iterator compatibility */
+		using value_type = char;
+
+		/** @brief Immutable iterator type for traversal */
+		using const_iterator = const char*;
+
+		/**
+		 * @brief Returns iterator to the first character
+		 * @return Const iterator pointing to the first character
+		 */
+		inline const_iterator begin() const noexcept;
+
+		/**
+		 * @brief Returns iterator one past the last character
+		 * @return Const iterator pointing one past the last character
+		 */
+		inline const_iterator end() const noexcept;
+
+	private:
+		//----------------------------------------------
+		// Private implementation methods
+		//----------------------------------------------
+
+		/** @brief Returns buffer to pool and empties the string */
+		void dispose() noexcept;
+
+		//----------------------------------------------
+		// Private member variables
+		//----------------------------------------------
+
+		/** @brief Pointer to the owned pooled buffer, nullptr when empty */
+		DynamicStringBuffer* m_buffer;
+
+		/** @brief Thread that leased the buffer, nullptr if origin is not tracked */
+		const void* m_origin;
+	};
+
 	//=====================================================================
 	// StringBuilderLease class
 	//=====================================================================
@@ -700,8 +1160,12 @@ namespace nfx::string
 		// Construction
 		//----------------------------------------------
 	private:
-		/** @brief Constructs lease with pooled buffer ownership */
-		inline explicit StringBuilderLease( DynamicStringBuffer* buffer );
+		/**
+		 * @brief Constructs lease with pooled buffer ownership
+		 * @param buffer Pooled buffer
+		 * @param origin Thread token of the leasing thread, or nullptr to skip origin tracking
+		 */
+		inline explicit StringBuilderLease( DynamicStringBuffer* buffer, const void* origin = nullptr );
 
 	public:
 		/** @brief Default constructor */
@@ -762,6 +1226,38 @@ namespace nfx::string
 		 */
 		[[nodiscard]] inline std::string toString() const;
 
+		/**
+		 * @brief Moves the leased buffer into a PooledString result
+		 * @return PooledString owning the buffer and its content, without copying
+		 * @details The lease becomes invalid; the buffer returns to the pool when the
+		 *          PooledString is destroyed, routed like the lease itself would have been
+		 * @throws std::runtime_error if the lease is no longer valid
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline PooledString take();
+
+		/**
+		 * @brief Interns the buffer contents
+		 * @return View of the canonical copy, valid for the lifetime of the process
+		 * @details Repeated results deduplicate to one stored copy with a single hash lookup,
+		 *          keyed by the buffer's hash(): with incremental hashing enabled the content is
+		 *          not hashed again. The lease stays valid and its content is unchanged.
+		 * @throws std::runtime_error if the lease is no longer valid
+		 * @see StringBuilderPool::intern()
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] std::string_view intern() const;
+
+		/**
+		 * @brief Gets heterogeneous lookup key for the buffer contents
+		 * @return StringKey viewing the buffer, valid until the buffer is modified or returned
+		 * @details Reuses the running hash when incremental hashing is enabled on the buffer
+		 * @throws std::runtime_error if the lease is no longer valid
+		 * @see StringKeyHash, StringKeyEqual
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] inline StringKey key() const;
+
 	private:
 		//----------------------------------------------
 		// Private implementation methods
@@ -782,6 +1278,9 @@ namespace nfx::string
 
 		/** @brief Flag indicating if the lease is valid and buffer is accessible */
 		bool m_valid;
+
+		/** @brief Thread that leased the buffer, nullptr if origin is not tracked */
+		const void* m_origin;
 	};
 
 	//=====================================================================
@@ -837,10 +1336,10 @@ namespace nfx::string
 	 * Buffer Return Process (via StringBuilderLease destructor):
 	 * ┌─────────────────────────────────────────────────────────────┐
 	 * │  1. Clear buffer content (zero-cost operation)              │
-	 * │  2. Check size limits (prevent memory bloat)                │
+	 * │  2. Shrink oversized buffers (prevent memory bloat)         │
 	 * │  3. Return to thread-local cache (if space available)       │
 	 * │  4. Return to shared pool (if thread-local full)            │
-	 * │  5. Deallocate (if both pools full or buffer too large)     │
+	 * │  5. Deallocate (if both pools full)                         │
 	 * └─────────────────────────────────────────────────────────────┘
 	 * ```
 	 *
@@ -848,7 +1347,7 @@ namespace nfx::string
 	 *       All pool operations are thread-safe and optimized for concurrent access patterns.
 	 *
 	 * @warning Pool buffers have size limits to prevent memory bloat - extremely large buffers
-	 *          may not be returned to the pool and will be deallocated normally.
+	 *          have their heap storage released on return and are pooled at their initial capacity.
 	 *
 	 * @see StringBuilderLease for RAII buffer management
 	 * @see StringBuilder for the high-level string building interface
@@ -857,6 +1356,91 @@ namespace nfx::string
 	class StringBuilderPool final
 	{
 	public:
+		//----------------------------------------------
+		// Constants
+		//----------------------------------------------
+
+		/** @brief Default address space reserved by leaseStable() (1 GB) */
+		static constexpr size_t DEFAULT_STABLE_CAPACITY = size_t{ 1 } << 30;
+
+		//----------------------------------------------
+		// Histogram structure
+		//----------------------------------------------
+
+		/**
+		 * @brief Log-linear histogram of unsigned 64-bit values
+		 * @details HDR-style bucketing: values below 8 get exact buckets, larger values are split
+		 *          into 8 linear sub-buckets per power of two, bounding the relative error of any
+		 *          recorded value to 12.5% across the full 64-bit range with a fixed bucket array.
+		 *          Value-initialize with {} to obtain an empty histogram.
+		 */
+		struct Histogram
+		{
+			/** @brief Linear sub-buckets per power of two */
+			static constexpr size_t SUB_BUCKET_COUNT = 8;
+
+			/** @brief Total number of buckets covering [0, 2^64) */
+			static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT * 62;
+
+			/**
+			 * @brief Gets bucket index of a value
+			 * @param value Value to classify
+			 * @return Index in [0, BUCKET_COUNT)
+			 */
+			[[nodiscard]] static size_t bucketIndex( uint64_t value ) noexcept;
+
+			/**
+			 * @brief Gets smallest value falling into a bucket
+			 * @param index Bucket index
+			 * @return Inclusive lower bound of the bucket
+			 */
+			[[nodiscard]] static uint64_t bucketLowerBound( size_t index ) noexcept;
+
+			/**
+			 * @brief Gets largest value falling into a bucket
+			 * @param index Bucket index
+			 * @return Inclusive upper bound of the bucket
+			 */
+			[[nodiscard]] static uint64_t bucketUpperBound( size_t index ) noexcept;
+
+			/**
+			 * @brief Records a value
+			 * @param value Value to record
+			 */
+			void record( uint64_t value ) noexcept;
+
+			/**
+			 * @brief Adds another histogram's recordings to this one
+			 * @param other Histogram to merge
+			 */
+			void merge( const Histogram& other ) noexcept;
+
+			/**
+			 * @brief Gets value at a percentile
+			 * @param percentile Percentile in [0, 100]
+			 * @return Upper bound of the bucket holding the percentile, capped at max; 0 if empty
+			 */
+			[[nodiscard]] uint64_t percentile( double percentile ) const noexcept;
+
+			/**
+			 * @brief Gets arithmetic mean of recorded values
+			 * @return Mean value, 0.0 if empty
+			 */
+			[[nodiscard]] double mean() const noexcept;
+
+			/** @brief Number of values recorded in each bucket */
+			std::array<uint64_t, BUCKET_COUNT> buckets;
+
+			/** @brief Number of recorded values */
+			uint64_t count;
+
+			/** @brief Sum of recorded values */
+			uint64_t sum;
+
+			/** @brief Largest recorded value */
+			uint64_t max;
+		};
+
 		//----------------------------------------------
 		// Pool statistics structure
 		//----------------------------------------------
@@ -876,8 +1460,180 @@ namespace nfx::string
 			/** @brief Total number of buffer requests made to the pool */
 			uint64_t totalRequests;
 
+			/** @brief Number of oversized returned buffers shrunk back to the initial capacity */
+			uint64_t oversizeShrinks;
+
+			/** @brief Number of oversized returned buffers deleted (shrinking disabled or failed) */
+			uint64_t oversizeDiscards;
+
+			/** @brief Number of returned buffers deleted because the shared pool was full */
+			uint64_t poolFullDiscards;
+
+			/** @brief Number of returned buffers parked in a thread-local cache */
+			uint64_t threadLocalParks;
+
+			/** @brief Number of returned buffers parked in the shared pool */
+			uint64_t sharedPoolParks;
+
+			/** @brief Number of capacity growths (reallocations and in-place commits) during leases, counted when the buffer returns */
+			uint64_t heapGrowths;
+			/** @brief Bytes copied into new storage by reallocating growths (at most 4 GiB counted per lease) */
+			/** @brief Bytes copied into new storage by reallocating growths */
+			uint64_t bytesCopiedOnGrowth;
+
 			/** @brief Cache hit rate as a percentage (0.0 to 1.0) */
 			double hitRate;
+
+			/** @brief Lease hold time in nanoseconds, recorded while histograms are enabled */
+			Histogram leaseDuration;
+
+			/** @brief Buffer content size in bytes when the lease ends, recorded while histograms are enabled */
+			Histogram bufferSize;
+
+			/** @brief Capacity growths per lease, recorded while histograms are enabled */
+			Histogram growthEvents;
+		};
+
+		//----------------------------------------------
+		// Lease attribution structure
+		//----------------------------------------------
+
+		/** @brief Statistics of sampled leases from one call site */
+		struct LeaseSiteStatistics
+		{
+			/** @brief Source file of the lease() call */
+			std::string_view file;
+
+			/** @brief Function containing the lease() call */
+			std::string_view function;
+
+			/** @brief Line of the lease() call */
+			uint32_t line;
+
+			/** @brief Column of the lease() call */
+			uint32_t column;
+
+			/** @brief Number of sampled leases from this call site */
+			uint64_t sampledLeases;
+
+			/** @brief Sum of buffer content sizes at return in bytes */
+			uint64_t totalBytes;
+
+			/** @brief Largest buffer content size at return in bytes */
+			uint64_t maxBytes;
+
+			/** @brief Sum of lease hold times in nanoseconds */
+			uint64_t totalNanoseconds;
+
+			/** @brief Longest lease hold time in nanoseconds */
+			uint64_t maxNanoseconds;
+		};
+
+		//----------------------------------------------
+		// Lease tracking structure
+		//----------------------------------------------
+
+		/** @brief A tracked lease whose buffer has not been returned to the pool */
+		struct OutstandingLease
+		{
+			/** @brief Source file of the lease() call */
+			std::string_view file;
+
+			/** @brief Function containing the lease() call */
+			std::string_view function;
+
+			/** @brief Line of the lease() call */
+			uint32_t line;
+
+			/** @brief Column of the lease() call */
+			uint32_t column;
+
+			/** @brief Thread that took the lease */
+			std::thread::id thread;
+
+			/** @brief Time since the lease was taken in nanoseconds */
+			uint64_t ageNanoseconds;
+		};
+
+		//----------------------------------------------
+		// Metrics export structure
+		//----------------------------------------------
+
+		/** @brief Statistics snapshot labelled with the name of the pool it came from */
+		struct MetricsSource
+		{
+			/** @brief Pool name, exported as the pool label */
+			std::string_view name;
+
+			/** @brief Statistics of the pool */
+			const PoolStatistics& statistics;
+		};
+
+		//----------------------------------------------
+		// Memory usage structure
+		//----------------------------------------------
+
+		/**
+		 * @brief Memory held by idle pooled buffers
+		 * @details Bytes count each buffer object (including its inline stack buffer) plus its heap
+		 *          block or committed address range. Leased buffers are not included.
+		 */
+		struct MemoryUsage
+		{
+			/** @brief Buffers parked in the shared pool */
+			size_t sharedPoolBuffers;
+
+			/** @brief Bytes held by buffers parked in the shared pool */
+			uint64_t sharedPoolBytes;
+
+			/** @brief Buffers parked in the calling thread's cache (0 or 1) */
+			size_t threadLocalBuffers;
+
+			/** @brief Bytes held by the calling thread's cached buffer */
+			uint64_t threadLocalBytes;
+		};
+
+		/** @brief Idle buffer held in one thread's cache */
+		struct ThreadCacheSnapshot
+		{
+			/** @brief Thread owning the cache */
+			std::thread::id thread;
+
+			/** @brief Buffers parked in the cache (0 or 1) */
+			size_t buffers;
+
+			/** @brief Capacity of the cached buffer in bytes, 0 if the cache is empty */
+			uint64_t capacity;
+
+			/** @brief Bytes held by the cached buffer, counted as in MemoryUsage */
+			uint64_t retainedBytes;
+		};
+
+		/**
+		 * @brief Idle pooled buffers across the shared pool and every thread's cache
+		 * @details Leased buffers are not included. Per-thread figures are published by each thread
+		 *          as it parks or takes its cached buffer, so a thread caught mid-lease may be one
+		 *          step behind.
+		 */
+		struct PoolSnapshot
+		{
+			/** @brief Buffers parked in the shared pool */
+			size_t sharedPoolBuffers;
+
+			/** @brief Total capacity of buffers parked in the shared pool */
+			uint64_t sharedPoolCapacity;
+
+			/** @brief Bytes held by buffers parked in the shared pool */
+			uint64_t sharedPoolBytes;
+
+			/** @brief One entry per live thread that has cached a buffer, in registration order */
+			std::vector<ThreadCacheSnapshot> threadCaches;
+
+			/** @brief Idle buffers in the shared pool and all thread caches */
+			size_t totalBuffers;
+
+			/** @brief Bytes held by all idle buffers */
+			uint64_t totalRetainedBytes;
 		};
 
 	private:
@@ -908,8 +1664,65 @@ namespace nfx::string
 		 *
 		 * This method is thread-safe and optimized for high-frequency usage patterns.
 		 * Buffers are automatically cleared before reuse and size-limited to prevent bloat.
+		 *
+		 * @param location Call site, captured automatically for lease attribution (see setLeaseSampling())
 		 */
-		[[nodiscard]] static StringBuilderLease lease();
+		[[nodiscard]] static StringBuilderLease lease( std::source_location location = std::source_location::current() );
+
+		/**
+		 * @brief Creates a StringBuilder lease whose content never moves while building
+		 * @param maxCapacity Upper bound on the built content in bytes (reserved address space)
+		 * @param location Call site, captured automatically for lease attribution
+		 * @return StringBuilderLease over a buffer in reservation mode
+		 *
+		 * The buffer reserves maxCapacity bytes of address space and commits pages on demand, so
+		 * previously appended bytes keep their address and views obtained with StringBuilder::view()
+		 * or DynamicStringBuffer::view() stay valid until the lease is released or the buffer is cleared.
+		 * When the lease ends the buffer is treated like any other oversized buffer: it is deleted,
+		 * or, with setShrinkOversizedBuffers( true ), its reserved range is released and it returns
+		 * to the pool at its initial capacity.
+		 *
+		 * @throws std::bad_alloc if the address range cannot be reserved
+		 */
+		[[nodiscard]] static StringBuilderLease leaseStable(
+			size_t maxCapacity = DEFAULT_STABLE_CAPACITY,
+			std::source_location location = std::source_location::current() );
+
+		/**
+		 * @brief Creates a StringBuilder lease that may be released on another thread
+		 * @return StringBuilderLease remembering the thread it was leased on
+		 *
+		 * Intended for leases held across co_await in coroutines that can resume on a different
+		 * executor thread. Released on the leasing thread, the buffer takes the usual thread-local
+		 * path; released elsewhere, it goes straight to the shared pool, where the leasing thread
+		 * can pick it up again instead of it stranding in the releasing thread's cache.
+		 *
+		 * @param location Call site, captured automatically for lease attribution
+		 */
+		[[nodiscard]] static StringBuilderLease asyncLease( std::source_location location = std::source_location::current() );
+
+		//----------------------------
+		// String interning
+		//----------------------------
+
+		/**
+		 * @brief Returns the canonical copy of a string from the process-wide intern table
+		 * @param str String to intern
+		 * @return View of the interned copy, valid for the lifetime of the process
+		 *
+		 * The intern table is a sharded, hash-indexed arena: each distinct string is copied once
+		 * into append-only storage that is never moved or freed. Lookups are thread-safe and cost
+		 * one hash computation plus one probe sequence under a per-shard lock.
+		 *
+		 * @throws std::bad_alloc if the table cannot grow
+		 */
+		[[nodiscard]] static std::string_view intern( std::string_view str );
+
+		/**
+		 * @brief Gets number of distinct strings in the intern table
+		 * @return Number of interned strings
+		 */
+		static size_t internedCount() noexcept;
 
 		//----------------------------
 		// Statistics methods
@@ -924,6 +1737,181 @@ namespace nfx::string
 		/** @brief Resets pool statistics */
 		static void resetStats() noexcept;
 
+		/**
+		 * @brief Measures memory retained by idle pooled buffers
+		 * @return Shared pool usage and the calling thread's cache usage
+		 * @details Other threads' caches are not visible here; to account for a worker's cache,
+		 *          call this on the worker before it exits.
+		 */
+		static MemoryUsage memoryUsage() noexcept;
+
+		/**
+		 * @brief Captures where idle pool memory lives across all threads
+		 * @return Shared pool totals and the cache of every live thread that has cached a buffer
+		 * @details Reads the capacity and footprint each thread publishes when it caches a buffer,
+		 *          never the buffer itself, so the thread is neither stopped nor locked out of its
+		 *          cache and may grow a leased buffer meanwhile. A thread leasing or returning its
+		 *          buffer during the snapshot may be counted either way; the figures are approximate.
+		 * @throws std::bad_alloc if the result cannot be allocated
+		 */
+		[[nodiscard]] static PoolSnapshot snapshot();
+
+		//----------------------------
+		// Lease attribution
+		//----------------------------
+
+		/**
+		 * @brief Sets lease attribution sampling
+		 * @param interval Record 1 in interval leases per thread against their call site, 0 to disable
+		 * @details Disabled by default, costing one relaxed load per lease. Sampled leases record
+		 *          their content size and hold time when the buffer returns to the pool, including
+		 *          through a PooledString. Up to 1024 distinct call sites are tracked in a lock-free table.
+		 */
+		static void setLeaseSampling( uint32_t interval ) noexcept;
+
+		/**
+		 * @brief Gets lease attribution sampling interval
+		 * @return Current interval, 0 if disabled
+		 */
+		static uint32_t leaseSampling() noexcept;
+
+		/**
+		 * @brief Dumps lease attribution statistics
+		 * @return One entry per call site seen while sampling, largest total bytes first
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] static std::vector<LeaseSiteStatistics> leaseSites();
+
+		/**
+		 * @brief Gets number of sampled leases that could not be attributed
+		 * @return Samples dropped because all 1024 call site slots were taken
+		 * @details Non-zero means leaseSites() under-reports - sites beyond the table's capacity
+		 *          are missing from it.
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] static uint64_t droppedLeaseSamples() noexcept;
+
+		/** @brief Zeroes lease attribution statistics and the dropped sample count, keeping the known call sites */
+		static void resetLeaseSites() noexcept;
+
+		//----------------------------
+		// Lease tracking
+		//----------------------------
+
+		/**
+		 * @brief Enables or disables outstanding lease tracking
+		 * @param enabled true to record the call site, start time and thread of every new lease
+		 * @details Disabled by default. While enabled, each lease and return takes a process-wide
+		 *          mutex and each lease allocates a registry entry, so enable it while hunting hoarded
+		 *          buffers rather than in production. Leases recorded before disabling are still
+		 *          removed when they return.
+		 */
+		static void setLeaseTracking( bool enabled ) noexcept;
+
+		/**
+		 * @brief Checks if outstanding lease tracking is enabled
+		 * @return true if new leases are recorded
+		 */
+		static bool leaseTracking() noexcept;
+
+		/**
+		 * @brief Gets number of tracked leases whose buffers have not been returned
+		 * @return Outstanding lease count; a count that keeps rising points at hoarded leases
+		 */
+		static size_t outstandingLeaseCount() noexcept;
+
+		/**
+		 * @brief Dumps tracked leases held at least a given time
+		 * @param minimumAgeNanoseconds Age threshold, 0 for every outstanding lease
+		 * @return Matching leases, oldest first
+		 * @note This function is marked [[nodiscard]] - the return value should not be ignored
+		 */
+		[[nodiscard]] static std::vector<OutstandingLease> outstandingLeases( uint64_t minimumAgeNanoseconds = 0 );
+
+		/**
+		 * @brief Writes the current pool statistics in OpenMetrics text format
+		 * @param builder Destination builder, typically from a pooled lease
+		 * @param poolName Value of the pool label
+		 * @details Equivalent to exporting a single MetricsSource holding stats().
+		 */
+		static void exportOpenMetrics( StringBuilder& builder, std::string_view poolName = "default" );
+
+		/**
+		 * @brief Writes statistics of several pools in OpenMetrics text format
+		 * @param builder Destination builder, typically from a pooled lease
+		 * @param sources Named statistics snapshots, one pool label value each
+		 * @details Emits every counter as a _total counter, the hit rate as a gauge and each
+		 *          histogram with power-of-two le buckets (lease durations in seconds), followed by
+		 *          the terminating # EOF line. Numbers are formatted in place with std::to_chars,
+		 *          so nothing is allocated beyond the builder's pooled buffer.
+		 */
+		static void exportOpenMetrics( StringBuilder& builder, std::span<const MetricsSource> sources );
+
+		/**
+		 * @brief Enables or disables lease histograms
+		 * @param enabled true to record lease duration, buffer size and growth histograms
+		 * @details Disabled by default. Recording accumulates into per-thread histograms without
+		 *          synchronization; stats() merges them. Leases started while disabled are not recorded.
+		 */
+		static void setHistogramsEnabled( bool enabled ) noexcept;
+
+		/**
+		 * @brief Checks if lease histograms are recorded
+		 * @return true if histograms are enabled
+		 */
+		static bool histogramsEnabled() noexcept;
+
+		//----------------------------
+		// Memory resource
+		//----------------------------
+
+		/**
+		 * @brief Sets the memory resource supplying heap storage of pooled buffers
+		 * @param resource Resource for subsequent heap allocations, nullptr to restore the default
+		 *        (cache-line-aligned operator new, huge-page mappings for large blocks)
+		 * @return Previously installed resource, nullptr if it was the default
+		 * @details Every heap block goes back to the resource it came from, so the resource can be
+		 *          changed while buffers hold storage from an earlier one. Blocks are requested with
+		 *          64-byte alignment. A resource must outlive all storage allocated from it, and must be
+		 *          thread-safe unless buffers are only leased and released on a single thread.
+		 * @throws std::length_error if 255 distinct resources are already registered
+		 */
+		static std::pmr::memory_resource* setMemoryResource( std::pmr::memory_resource* resource );
+
+		/**
+		 * @brief Gets the memory resource supplying heap storage of pooled buffers
+		 * @return Installed resource, nullptr for the default
+		 */
+		static std::pmr::memory_resource* memoryResource() noexcept;
+
+		//----------------------------
+		// Trace recording
+		//----------------------------
+
+		/**
+		 * @brief Starts recording lease and return events to a binary trace file
+		 * @param path Destination file, truncated
+		 * @details Each event is a 24-byte record (timestamp, buffer identity, thread, content size
+		 *          on return). Replay a trace with the pool simulator (NFX_STRINGBUILDERPOOL_BUILD_TOOLS)
+		 *          to compare pool configurations offline. Recording serializes pool traffic on a mutex,
+		 *          so keep capture sessions short; while stopped the cost is one relaxed load per event.
+		 * @throws std::logic_error if a trace is already being recorded
+		 * @throws std::runtime_error if the file cannot be opened or written
+		 */
+		static void startTrace( const std::string& path );
+
+		/**
+		 * @brief Stops recording and closes the trace file
+		 * @return Number of records written, 0 if no trace was being recorded
+		 */
+		static uint64_t stopTrace() noexcept;
+
+		/**
+		 * @brief Checks if a trace is being recorded
+		 * @return true between startTrace() and stopTrace(), or until a write error
+		 */
+		static bool isTracing() noexcept;
+
 		//----------------------------
 		// Lease management
 		//----------------------------
@@ -939,6 +1927,22 @@ namespace nfx::string
 		 * @return Number of buffers currently available in the pool
 		 */
 		static size_t size() noexcept;
+
+		/**
+		 * @brief Enables or disables shrinking of oversized returned buffers
+		 * @param enabled true to release the heap storage of buffers returned above the retained
+		 *        capacity (2048 bytes) and pool them at their initial capacity
+		 * @details Disabled by default: oversized buffers are deleted on return. Enabling it keeps the
+		 *          buffer objects pooled after bursts of large strings, at the cost of an allocation
+		 *          when the next lease grows past the initial capacity again.
+		 */
+		static void setShrinkOversizedBuffers( bool enabled ) noexcept;
+
+		/**
+		 * @brief Checks if oversized returned buffers are shrunk
+		 * @return true if oversized buffers are shrunk and pooled, false if they are deleted
+		 */
+		static bool shrinkOversizedBuffers() noexcept;
 	};
 } // namespace nfx::string
 
@@ -27,7 +27,17 @@
  * @brief Implementation of thread-safe shared memory buffer pool
  */
 
+#include <algorithm>
+#include <new>
+#include <utility>
+
 #include "DynamicStringBufferPool.h"
+#include "LeaseAttribution.h"
+#include "LeaseTracker.h"
+#include "PoolFeatures.h"
+#include "PoolHistograms.h"
+#include "PoolTraceRecorder.h"
+#include "Probes.h"
 #include "nfx/string/StringBuilderPool.h"
 
 namespace nfx::string
@@ -37,23 +47,64 @@ namespace nfx::string
 	//=====================================================================
 
 	/** @brief Thread-local cache for single buffer to optimize sequential allocations */
-	thread_local DynamicStringBuffer* t_cachedBuffer = nullptr;
+	constinit thread_local DynamicStringBufferPool::ThreadCache t_cache{};
+
+	namespace
+	{
+		/**
+		 * @brief True while the singleton pool is alive
+		 * @details Constant-initialized, so it reads false both before the pool is first constructed
+		 *          and after static destruction has destroyed it.
+		 */
+		constinit std::atomic<bool> g_sharedPoolAlive{ false };
+
+		/** @brief Owns the singleton pool and publishes its lifetime in g_sharedPoolAlive */
+		struct SharedPoolHolder
+		{
+			SharedPoolHolder()
+			{
+				g_sharedPoolAlive.store( true, std::memory_order_release );
+			}
+
+			~SharedPoolHolder()
+			{
+				// Runs before pool is destroyed
+				g_sharedPoolAlive.store( false, std::memory_order_release );
+			}
+
+			/** @brief Parameters: 256-byte initial capacity, 2048-byte max retained, 24 buffer pool size, delete oversized buffers */
+			DynamicStringBufferPool pool{ 256, 2048, 24, false };
+		};
+	} // namespace
 
 	/**
-	 * @brief Thread-local RAII cleanup object to prevent memory leaks on thread exit
-	 * @details This object exists purely for its destructor behavior, ensuring automatic cleanup
-	 *          of cached buffers when threads terminate. Uses RAII pattern for deterministic cleanup.
+	 * @brief Thread-local RAII cleanup object handing the cached buffer on at thread exit
+	 * @details Armed when the thread first parks a buffer, so threads that never cache one pay
+	 *          nothing. On thread exit the cached buffer is handed to the shared pool, subject to
+	 *          its size limit, so warm buffers outlive short-lived worker threads. Once the pool has
+	 *          been destroyed during static destruction the buffer is deleted instead.
 	 */
 	thread_local struct ThreadLocalCleanup
 	{
 		~ThreadLocalCleanup()
 		{
-			if ( t_cachedBuffer )
+			if ( !armed )
 			{
-				delete t_cachedBuffer;
-				t_cachedBuffer = nullptr;
+				return;
+			}
+
+			if ( g_sharedPoolAlive.load( std::memory_order_acquire ) )
+			{
+				dynamicStringBufferPool().retireThreadCache( &t_cache );
+			}
+			else if ( auto* buffer = std::exchange( t_cache.buffer, nullptr ) )
+			{
+				delete buffer;
 			}
 		}
+
+		/** @brief True once t_cache is registered and needs retiring */
+		bool armed = false;
 	} t_cleanup; // Thread-local cleanup instance for automatic buffer deallocation on thread exit
 
 	//=====================================================================
@@ -78,16 +129,16 @@ namespace nfx::string
 	// Pool management methods
 	//----------------------------------------------
 
-	DynamicStringBuffer* DynamicStringBufferPool::get()
+	DynamicStringBuffer* DynamicStringBufferPool::get( const std::source_location& location )
 	{
 		m_stats.totalRequests.fetch_add( 1, std::memory_order_relaxed );
 
-		if ( t_cachedBuffer )
+		if ( auto* buffer = takeFromThreadCache() )
 		{
 			m_stats.threadLocalHits.fetch_add( 1, std::memory_order_relaxed );
-			auto* buffer = t_cachedBuffer;
-			t_cachedBuffer = nullptr;
 			buffer->clear();
+			beginLease( buffer, location );
+			NFX_STRINGBUILDERPOOL_PROBE1( get_thread_local_hit, buffer );
 
 			return buffer;
 		}
@@ -109,42 +160,292 @@ namespace nfx::string
 			m_stats.newAllocations.fetch_add( 1, std::memory_order_relaxed );
 			buffer = new DynamicStringBuffer{};
 			buffer->reserve( m_initialCapacity );
+			NFX_STRINGBUILDERPOOL_PROBE1( get_miss, buffer );
 		}
 		else
 		{
 			buffer->clear();
+			NFX_STRINGBUILDERPOOL_PROBE1( get_shared_pool_hit, buffer );
 		}
+		beginLease( buffer, location );
 
 		return buffer;
 	}
 
 	void DynamicStringBufferPool::returnToPool( DynamicStringBuffer* buffer )
 	{
-		if ( !buffer )
+		if ( !buffer || !reclaim( buffer, false ) )
 		{
 			return;
 		}
 
-		if ( buffer->capacity() > m_maximumRetainedCapacity )
+		if ( !t_cache.buffer )
 		{
-			delete buffer;
+			parkInThreadCache( buffer );
+
 			return;
 		}
 
-		if ( !t_cachedBuffer )
+		parkInSharedPool( buffer );
+	}
+
+	void DynamicStringBufferPool::returnToSharedPool( DynamicStringBuffer* buffer )
+	{
+		if ( !buffer || !reclaim( buffer, true ) )
 		{
-			t_cachedBuffer = buffer;
+			return;
+		}
+
+		parkInSharedPool( buffer );
+	}
+
+	void DynamicStringBufferPool::setShrinkOversizedBuffers( bool enabled ) noexcept
+	{
+		m_shrinkOversizedBuffers.store( enabled, std::memory_order_relaxed );
+	}
+
+	bool DynamicStringBufferPool::shrinkOversizedBuffers() const noexcept
+	{
+		return m_shrinkOversizedBuffers.load( std::memory_order_relaxed );
+	}
+
+	const void* DynamicStringBufferPool::threadToken() noexcept
+	{
+		return &t_cache;
+	}
+
+	//----------------------------------------------
+	// Thread cache registry
+	//----------------------------------------------
+
+	void DynamicStringBufferPool::registerThreadCache( ThreadCache* cache )
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		m_threadCaches.push_back( { cache, std::this_thread::get_id() } );
+		cache->registered = true;
+	}
+
+	void DynamicStringBufferPool::retireThreadCache( ThreadCache* cache ) noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		std::erase_if( m_threadCaches, [cache]( const ThreadCacheEntry& entry ) { return entry.cache == cache; } );
+		cache->registered = false;
+		cache->retired = true;
+		m_stats.threadLocalParks.fetch_add( cache->parks.load( std::memory_order_relaxed ) - cache->parksAtReset, std::memory_order_relaxed );
+
+		auto* buffer = std::exchange( cache->buffer, nullptr );
+		cache->capacity.store( 0, std::memory_order_relaxed );
+		cache->retainedBytes.store( 0, std::memory_order_relaxed );
 
+		if ( !buffer )
+		{
 			return;
 		}
 
+		if ( m_pool.size() < m_maxPoolSize )
+		{
+			try
+			{
+				m_pool.push_back( buffer );
+				m_stats.sharedPoolParks.fetch_add( 1, std::memory_order_relaxed );
+				NFX_STRINGBUILDERPOOL_PROBE2( return_shared_pool, buffer, buffer->size() );
+
+				return;
+			}
+			catch ( const std::bad_alloc& )
+			{
+				// Fall through and delete the buffer
+			}
+		}
+
+		m_stats.poolFullDiscards.fetch_add( 1, std::memory_order_relaxed );
+		NFX_STRINGBUILDERPOOL_PROBE2( discard_pool_full, buffer, buffer->capacity() );
+		delete buffer;
+	}
+
+	//----------------------------------------------
+	// Private implementation methods
+	//----------------------------------------------
+
+	void DynamicStringBufferPool::beginLease( DynamicStringBuffer* buffer, const std::source_location& location ) noexcept
+	{
+		buffer->m_growthCount = 0;
+		buffer->m_growthBytesCopied = 0;
+		buffer->m_attributionSite = 0;
+		buffer->m_leaseStart = 0;
+
+		const uint32_t features = poolFeatures();
+		if ( features == 0 )
+		{
+			return;
+		}
+
+		if ( features & PoolFeature::Histograms )
+		{
+			buffer->m_leaseStart = PoolHistograms::now();
+		}
+		if ( features & PoolFeature::Trace )
+		{
+			poolTraceRecorder().record( PoolTraceEvent::Lease, buffer, 0 );
+		}
+		if ( features & PoolFeature::LeaseTracking )
+		{
+			leaseTracker().track( buffer, location );
+		}
+		if ( features & PoolFeature::Attribution )
+		{
+			buffer->m_attributionSite = leaseAttribution().sample( location );
+			if ( buffer->m_attributionSite != 0 && buffer->m_leaseStart == 0 )
+			{
+				buffer->m_leaseStart = PoolHistograms::now();
+			}
+		}
+	}
+
+	bool DynamicStringBufferPool::reclaim( DynamicStringBuffer* buffer, bool toSharedPool )
+	{
+		const uint32_t features = poolFeatures();
+		if ( features & PoolFeature::TrackedLeases )
+		{
+			leaseTracker().release( buffer );
+		}
+		if ( features & PoolFeature::Trace )
+		{
+			poolTraceRecorder().record( PoolTraceEvent::Return, buffer, buffer->size(), toSharedPool ? PoolTraceFlag::SharedPool : 0 );
+		}
+
+		if ( buffer->m_leaseStart != 0 )
+		{
+			const uint64_t duration = PoolHistograms::now() - buffer->m_leaseStart;
+			if ( buffer->m_attributionSite != 0 )
+			{
+				leaseAttribution().record( buffer->m_attributionSite, buffer->size(), duration );
+			}
+
+			try
+			{
+				if ( features & PoolFeature::Histograms )
+				{
+					poolHistograms().recordLease( duration, buffer->size(), buffer->m_growthCount );
+				}
+			}
+			catch ( const std::bad_alloc& )
+			{
+				// First recording on this thread could not allocate its histograms - skip the sample
+			}
+		}
+
+		// Only buffers that grew while leased touch the shared counters
+		if ( buffer->m_growthCount != 0 )
+		{
+			m_stats.heapGrowths.fetch_add( buffer->m_growthCount, std::memory_order_relaxed );
+			m_stats.bytesCopiedOnGrowth.fetch_add( buffer->m_growthBytesCopied, std::memory_order_relaxed );
+		}
+
+		// Per-lease modes do not carry over to the next lease
+		buffer->disableIncrementalHash();
+
+		if ( buffer->capacity() > m_maximumRetainedCapacity || buffer->m_reservedCapacity > 0 )
+		{
+			if ( !m_shrinkOversizedBuffers.load( std::memory_order_relaxed ) )
+			{
+				m_stats.oversizeDiscards.fetch_add( 1, std::memory_order_relaxed );
+				NFX_STRINGBUILDERPOOL_PROBE2( discard_oversize, buffer, buffer->capacity() );
+				delete buffer;
+				return false;
+			}
+
+			// Drop the heap block or address range but keep the buffer object
+			NFX_STRINGBUILDERPOOL_PROBE2( shrink_oversize, buffer, buffer->capacity() );
+			buffer->clear();
+			buffer->releaseHeapBuffer();
+			if ( m_initialCapacity > buffer->capacity() )
+			{
+				try
+				{
+					buffer->reserve( m_initialCapacity );
+				}
+				catch ( const std::bad_alloc& )
+				{
+					m_stats.oversizeDiscards.fetch_add( 1, std::memory_order_relaxed );
+					NFX_STRINGBUILDERPOOL_PROBE2( discard_oversize, buffer, buffer->capacity() );
+					delete buffer;
+					return false;
+				}
+			}
+			m_stats.oversizeShrinks.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		return true;
+	}
+
+	uint64_t DynamicStringBufferPool::footprint( const DynamicStringBuffer& buffer ) noexcept
+	{
+		return sizeof( DynamicStringBuffer ) + ( buffer.isOnHeap() ? buffer.capacity() : 0 );
+	}
+
+	void DynamicStringBufferPool::parkInThreadCache( DynamicStringBuffer* buffer )
+	{
+		if ( !t_cache.registered )
+		{
+			if ( t_cache.retired )
+			{
+				// Returned by another thread_local's destructor after this thread's cache retired
+				parkInSharedPool( buffer );
+
+				return;
+			}
+
+			try
+			{
+				registerThreadCache( &t_cache );
+			}
+			catch ( const std::bad_alloc& )
+			{
+				// An unregistered cache would be invisible to snapshots and skipped at thread exit
+				parkInSharedPool( buffer );
+
+				return;
+			}
+			t_cleanup.armed = true;
+		}
+
+		// Single writer - no locked read-modify-write on the return path
+		t_cache.parks.store( t_cache.parks.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+		NFX_STRINGBUILDERPOOL_PROBE2( return_thread_local, buffer, buffer->size() );
+		t_cache.buffer = buffer;
+
+		// snapshot() reads these figures instead of the buffer, which this thread may be growing
+		t_cache.capacity.store( buffer->capacity(), std::memory_order_relaxed );
+		t_cache.retainedBytes.store( footprint( *buffer ), std::memory_order_relaxed );
+	}
+
+	DynamicStringBuffer* DynamicStringBufferPool::takeFromThreadCache() noexcept
+	{
+		auto* buffer = t_cache.buffer;
+		if ( buffer )
+		{
+			t_cache.buffer = nullptr;
+			t_cache.capacity.store( 0, std::memory_order_relaxed );
+			t_cache.retainedBytes.store( 0, std::memory_order_relaxed );
+		}
+
+		return buffer;
+	}
+
+	void DynamicStringBufferPool::parkInSharedPool( DynamicStringBuffer* buffer )
+	{
 		std::lock_guard<std::mutex> lock{ m_mutex };
 		if ( m_pool.size() < m_maxPoolSize )
 		{
+			m_stats.sharedPoolParks.fetch_add( 1, std::memory_order_relaxed );
+			NFX_STRINGBUILDERPOOL_PROBE2( return_shared_pool, buffer, buffer->size() );
 			m_pool.push_back( buffer );
 		}
 		else
 		{
+			m_stats.poolFullDiscards.fetch_add( 1, std::memory_order_relaxed );
+			NFX_STRINGBUILDERPOOL_PROBE2( discard_pool_full, buffer, buffer->capacity() );
 			delete buffer;
 		}
 	}
@@ -175,6 +476,13 @@ namespace nfx::string
 		dynamicStringBufferPoolHits = 0;
 		newAllocations = 0;
 		totalRequests = 0;
+		oversizeShrinks = 0;
+		oversizeDiscards = 0;
+		poolFullDiscards = 0;
+		threadLocalParks = 0;
+		sharedPoolParks = 0;
+		heapGrowths = 0;
+		bytesCopiedOnGrowth = 0;
 	}
 
 	//----------------------------
@@ -200,10 +508,9 @@ namespace nfx::string
 		m_pool.clear();
 
 		// Clear this thread's cached buffer (each thread only touches its own)
-		if ( t_cachedBuffer )
+		if ( auto* buffer = takeFromThreadCache() )
 		{
-			delete t_cachedBuffer;
-			t_cachedBuffer = nullptr;
+			delete buffer;
 			clearedCount += 1;
 		}
 
@@ -217,7 +524,7 @@ namespace nfx::string
 		auto count = m_pool.size();
 
 		// Add this thread's cached buffer to the count
-		if ( t_cachedBuffer )
+		if ( t_cache.buffer )
 		{
 			count += 1;
 		}
@@ -225,8 +532,91 @@ namespace nfx::string
 		return count;
 	}
 
+	StringBuilderPool::MemoryUsage DynamicStringBufferPool::memoryUsage() const noexcept
+	{
+		StringBuilderPool::MemoryUsage usage{};
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			usage.sharedPoolBuffers = m_pool.size();
+			for ( const auto* buffer : m_pool )
+			{
+				usage.sharedPoolBytes += footprint( *buffer );
+			}
+		}
+
+		if ( const auto* buffer = t_cache.buffer )
+		{
+			usage.threadLocalBuffers = 1;
+			usage.threadLocalBytes = footprint( *buffer );
+		}
+
+		return usage;
+	}
+
+	StringBuilderPool::PoolSnapshot DynamicStringBufferPool::snapshot() const
+	{
+		StringBuilderPool::PoolSnapshot snapshot{};
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
+		snapshot.sharedPoolBuffers = m_pool.size();
+		for ( const auto* buffer : m_pool )
+		{
+			snapshot.sharedPoolCapacity += buffer->capacity();
+			snapshot.sharedPoolBytes += footprint( *buffer );
+		}
+		snapshot.totalBuffers = snapshot.sharedPoolBuffers;
+		snapshot.totalRetainedBytes = snapshot.sharedPoolBytes;
+
+		// Other threads' buffers are never dereferenced: their owners lease and grow them without
+		// the lock, so only the figures published at park time are read
+		snapshot.threadCaches.reserve( m_threadCaches.size() );
+		for ( const auto& entry : m_threadCaches )
+		{
+			const uint64_t retainedBytes = entry.cache->retainedBytes.load( std::memory_order_relaxed );
+			snapshot.threadCaches.push_back( {
+				entry.thread,
+				retainedBytes != 0 ? size_t{ 1 } : size_t{ 0 },
+				entry.cache->capacity.load( std::memory_order_relaxed ),
+				retainedBytes } );
+			snapshot.totalBuffers += snapshot.threadCaches.back().buffers;
+			snapshot.totalRetainedBytes += snapshot.threadCaches.back().retainedBytes;
+		}
+
+		return snapshot;
+	}
+
+	uint64_t DynamicStringBufferPool::threadLocalParks() const noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
+		uint64_t parks = m_stats.threadLocalParks.load( std::memory_order_relaxed );
+		for ( const auto& entry : m_threadCaches )
+		{
+			parks += entry.cache->parks.load( std::memory_order_relaxed ) - entry.cache->parksAtReset;
+		}
+
+		return parks;
+	}
+
 	void DynamicStringBufferPool::resetStats() noexcept
 	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
 		m_stats.reset();
+		for ( const auto& entry : m_threadCaches )
+		{
+			entry.cache->parksAtReset = entry.cache->parks.load( std::memory_order_relaxed );
+		}
+	}
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	DynamicStringBufferPool& dynamicStringBufferPool() noexcept
+	{
+		static SharedPoolHolder holder;
+
+		return holder.pool;
 	}
 } // namespace nfx::string
@@ -40,8 +40,12 @@
 #include <atomic>
 #include <cstdint>
 #include <mutex>
+#include <source_location>
+#include <thread>
 #include <vector>
 
+#include "nfx/string/StringBuilderPool.h"
+
 namespace nfx::string
 {
 	class DynamicStringBuffer;
@@ -57,7 +61,7 @@ namespace nfx::string
 	 *          2. Shared pool: Cross-thread buffer sharing with mutex protection (slower but still fast)
 	 *          3. New allocation: Only when both caches are exhausted (slowest)
 	 *
-	 * @note Thread-local buffers are automatically cleaned up when threads exit via ThreadLocalCleanup RAII pattern
+	 * @note Thread-local buffers are handed to the shared pool when threads exit via ThreadLocalCleanup RAII pattern
 	 */
 	class DynamicStringBufferPool final
 	{
@@ -71,14 +75,18 @@ namespace nfx::string
 		 * @param initialCapacity Initial buffer capacity for new allocations
 		 * @param maximumRetainedCapacity Maximum buffer size retained in pool before deletion
 		 * @param maxPoolSize Maximum number of buffers stored in the shared pool
+		 * @param shrinkOversizedBuffers Shrink returned buffers above maximumRetainedCapacity back to
+		 *        initialCapacity and keep them, instead of deleting them
 		 */
 		explicit DynamicStringBufferPool(
 			size_t initialCapacity = 256,
 			size_t maximumRetainedCapacity = 2048,
-			size_t maxPoolSize = 24 )
+			size_t maxPoolSize = 24,
+			bool shrinkOversizedBuffers = false )
 			: m_initialCapacity{ initialCapacity },
 			  m_maximumRetainedCapacity{ maximumRetainedCapacity },
-			  m_maxPoolSize{ maxPoolSize }
+			  m_maxPoolSize{ maxPoolSize },
+			  m_shrinkOversizedBuffers{ shrinkOversizedBuffers }
 		{
 		}
 
@@ -121,18 +129,97 @@ namespace nfx::string
 
 		/**
 		 * @brief Retrieves buffer from pool or creates new one
+		 * @param location Call site of the lease, for attribution and lease tracking
 		 * @return Pointer to memory buffer ready for use
 		 * @details Retrieval priority: 1) Thread-local cache, 2) Shared pool, 3) New allocation
 		 */
-		DynamicStringBuffer* get();
+		DynamicStringBuffer* get( const std::source_location& location );
 
 		/**
 		 * @brief Returns buffer to pool for reuse
 		 * @param buffer Buffer to return (must not be null, but method handles null gracefully)
-		 * @details Return priority: 1) Thread-local cache (if empty), 2) Shared pool (if not full), 3) Delete
+		 * @details Return priority: 1) Thread-local cache (if empty), 2) Shared pool (if not full), 3) Delete.
+		 *          Oversized buffers are shrunk back to the initial capacity first, or deleted when
+		 *          shrinking is disabled.
 		 */
 		void returnToPool( DynamicStringBuffer* buffer );
 
+		/**
+		 * @brief Returns buffer to the shared pool, bypassing the calling thread's cache
+		 * @param buffer Buffer to return (must not be null, but method handles null gracefully)
+		 * @details Used for buffers released on a thread other than the one that leased them, so the
+		 *          buffer stays reachable from the leasing thread instead of stranding in the cache
+		 *          of whichever thread happened to release it. Deletes the buffer if the pool is full.
+		 */
+		void returnToSharedPool( DynamicStringBuffer* buffer );
+
+		/**
+		 * @brief Enables or disables shrinking of oversized returned buffers
+		 * @param enabled true to shrink and pool oversized buffers, false to delete them
+		 */
+		void setShrinkOversizedBuffers( bool enabled ) noexcept;
+
+		/**
+		 * @brief Checks if oversized returned buffers are shrunk
+		 * @return true if oversized buffers are shrunk and pooled, false if they are deleted
+		 */
+		bool shrinkOversizedBuffers() const noexcept;
+
+		/**
+		 * @brief Gets an identifier of the calling thread
+		 * @return Address unique to the calling thread for its lifetime
+		 */
+		static const void* threadToken() noexcept;
+
+		//----------------------------------------------
+		// Thread cache registry
+		//----------------------------------------------
+
+		/**
+		 * @brief One thread's single-buffer cache
+		 * @details Constant-initialized and trivially destructible, so a thread_local instance is
+		 *          reached with a plain TLS access - no initialization guard or destructor
+		 *          registration on the lease and return paths.
+		 */
+		struct ThreadCache
+		{
+			/** @brief Cached buffer, accessed by the owning thread only */
+			DynamicStringBuffer* buffer{ nullptr };
+
+			/** @brief Capacity of the cached buffer, 0 if empty; published by the owning thread for snapshot() */
+			std::atomic<uint64_t> capacity{ 0 };
+
+			/** @brief Footprint of the cached buffer, 0 if empty; published by the owning thread for snapshot() */
+			std::atomic<uint64_t> retainedBytes{ 0 };
+
+			/** @brief Buffers parked in this cache, written by the owning thread only */
+			std::atomic<uint64_t> parks{ 0 };
+
+			/** @brief Value of parks at the last resetStats(), accessed under m_mutex */
+			uint64_t parksAtReset{ 0 };
+
+			/** @brief True while the cache is in the registry */
+			bool registered{ false };
+
+			/** @brief True once the owning thread has retired the cache on exit */
+			bool retired{ false };
+		};
+
+		/**
+		 * @brief Registers the calling thread's cache for snapshots and thread-exit handoff
+		 * @param cache Cache owned by the calling thread
+		 */
+		void registerThreadCache( ThreadCache* cache );
+
+		/**
+		 * @brief Unregisters an exiting thread's cache and hands its cached buffer to the shared pool
+		 * @param cache Cache owned by the exiting thread
+		 * @details The buffer was reclaimed when it was cached, so it is parked as is, or deleted if
+		 *          the shared pool is full. Buffers returned later during the thread's exit go
+		 *          straight to the shared pool.
+		 */
+		void retireThreadCache( ThreadCache* cache ) noexcept;
+
 		//----------------------------------------------
 		// Statistics
 		//----------------------------------------------
@@ -196,6 +283,27 @@ namespace nfx::string
 
 			/** @brief Total number of buffer requests made to the pool */
 			std::atomic<uint64_t> totalRequests{ 0 };
+
+			/** @brief Number of oversized buffers shrunk back to the initial capacity on return */
+			std::atomic<uint64_t> oversizeShrinks{ 0 };
+
+			/** @brief Number of oversized buffers deleted on return */
+			std::atomic<uint64_t> oversizeDiscards{ 0 };
+
+			/** @brief Number of returned buffers deleted because the shared pool was full */
+			std::atomic<uint64_t> poolFullDiscards{ 0 };
+
+			/** @brief Number of returned buffers parked in the caches of exited threads, see threadLocalParks() */
+			std::atomic<uint64_t> threadLocalParks{ 0 };
+
+			/** @brief Number of returned buffers parked in the shared pool */
+			std::atomic<uint64_t> sharedPoolParks{ 0 };
+
+			/** @brief Number of capacity growths (reallocations and in-place commits) during leases, counted by reclaim() */
+			std::atomic<uint64_t> heapGrowths{ 0 };
+
+			/** @brief Bytes copied into new storage by reallocating growths */
+			std::atomic<uint64_t> bytesCopiedOnGrowth{ 0 };
 		};
 
 		//----------------------------
@@ -222,10 +330,75 @@ namespace nfx::string
 		 */
 		size_t size() const noexcept;
 
+		/**
+		 * @brief Measures memory retained by idle buffers
+		 * @return Shared pool usage and the current thread's cache usage
+		 */
+		StringBuilderPool::MemoryUsage memoryUsage() const noexcept;
+
+		/**
+		 * @brief Captures idle buffers across the shared pool and all registered thread caches
+		 * @return Shared pool totals and one entry per registered thread
+		 */
+		StringBuilderPool::PoolSnapshot snapshot() const;
+
+		/**
+		 * @brief Gets number of returned buffers parked in a thread-local cache
+		 * @return Parks by exited threads plus the per-thread counts of live threads
+		 * @details Each thread counts its own parks without touching shared cache lines; the
+		 *          counts are summed here under m_mutex.
+		 */
+		uint64_t threadLocalParks() const noexcept;
+
 		/** @brief Resets pool statistics to zero */
 		void resetStats() noexcept;
 
 	private:
+		//----------------------------------------------
+		// Private implementation methods
+		//----------------------------------------------
+
+		/**
+		 * @brief Resets per-lease tracking of a buffer handed out by get() and starts the enabled instrumentation
+		 * @param buffer Buffer being leased
+		 * @param location Call site of the lease
+		 * @details Loads the PoolFeature mask once and skips every subsystem whose bit is clear.
+		 */
+		static void beginLease( DynamicStringBuffer* buffer, const std::source_location& location ) noexcept;
+
+		/**
+		 * @brief Prepares a returned buffer for reuse
+		 * @param buffer Buffer being returned
+		 * @param toSharedPool true if the return bypasses the calling thread's cache, for the trace
+		 * @return true if the buffer can be pooled, false if it was deleted
+		 */
+		bool reclaim( DynamicStringBuffer* buffer, bool toSharedPool );
+
+		/**
+		 * @brief Gets memory held by a buffer
+		 * @param buffer Buffer to measure
+		 * @return Object size plus heap block or committed address range
+		 */
+		static uint64_t footprint( const DynamicStringBuffer& buffer ) noexcept;
+
+		/**
+		 * @brief Stores buffer in the shared pool, deleting it if the pool is full
+		 * @param buffer Reclaimed buffer
+		 */
+		void parkInSharedPool( DynamicStringBuffer* buffer );
+
+		/**
+		 * @brief Stores buffer in the calling thread's empty cache, registering the cache on first use
+		 * @param buffer Reclaimed buffer
+		 */
+		void parkInThreadCache( DynamicStringBuffer* buffer );
+
+		/**
+		 * @brief Empties the calling thread's cache
+		 * @return Buffer that was cached, nullptr if the cache was empty
+		 */
+		static DynamicStringBuffer* takeFromThreadCache() noexcept;
+
 		//----------------------------------------------
 		// Private member variables
 		//----------------------------------------------
@@ -233,6 +406,19 @@ namespace nfx::string
 		/** @brief Vector containing available pooled buffers for cross-thread sharing */
 		std::vector<DynamicStringBuffer*> m_pool;
 
+		/** @brief Registry entry of one live thread's cache */
+		struct ThreadCacheEntry
+		{
+			/** @brief Cache owned by the thread */
+			ThreadCache* cache;
+
+			/** @brief Thread owning the cache */
+			std::thread::id thread;
+		};
+
+		/** @brief Caches of live threads, protected by m_mutex */
+		std::vector<ThreadCacheEntry> m_threadCaches;
+
 		/** @brief Mutex protecting shared pool access during concurrent operations */
 		mutable std::mutex m_mutex;
 
@@ -245,6 +431,9 @@ namespace nfx::string
 		/** @brief Maximum number of buffers stored in shared pool (prevents unbounded growth) */
 		const size_t m_maxPoolSize;
 
+		/** @brief Shrink oversized buffers on return instead of deleting them */
+		std::atomic<bool> m_shrinkOversizedBuffers;
+
 		/** @brief Pool performance statistics with atomic counters for thread safety */
 		mutable PoolStatistics m_stats;
 	};
@@ -256,13 +445,8 @@ namespace nfx::string
 	/**
 	 * @brief Gets the singleton DynamicStringBufferPool instance
 	 * @return Reference to the global shared pool instance
-	 * @details Uses static local variable for thread-safe initialization and automatic cleanup
+	 * @details Uses static local variable for thread-safe initialization and automatic cleanup.
+	 *          Defined out of line so that every translation unit shares one instance.
 	 */
-	inline static DynamicStringBufferPool& dynamicStringBufferPool() noexcept
-	{
-		// Parameters: 256-byte initial capacity, 2048-byte max retained, 24 buffer pool size
-		static DynamicStringBufferPool pool{ 256, 2048, 24 };
-
-		return pool;
-	}
+	DynamicStringBufferPool& dynamicStringBufferPool() noexcept;
 } // namespace nfx::string
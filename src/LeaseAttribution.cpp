@@ -0,0 +1,213 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file LeaseAttribution.cpp
+ * @brief Implementation of lock-free per-call-site lease statistics
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "LeaseAttribution.h"
+#include "PoolFeatures.h"
+
+namespace nfx::string
+{
+	namespace
+	{
+		//=====================================================================
+		// Sampling state
+		//=====================================================================
+
+		/** @brief Leases left before the calling thread samples again */
+		thread_local uint32_t t_sampleCountdown = 0;
+
+		/** @brief Identity hash of a call site, never 0 */
+		uint64_t siteKey( const std::source_location& location ) noexcept
+		{
+			uint64_t key = reinterpret_cast<uintptr_t>( location.file_name() );
+			key ^= ( static_cast<uint64_t>( location.line() ) << 32 ) ^ location.column();
+			key *= 0x9E3779B97F4A7C15ull;
+
+			return key | 1;
+		}
+
+		/** @brief Raises an atomic maximum */
+		void raise( std::atomic<uint64_t>& maximum, uint64_t value ) noexcept
+		{
+			uint64_t current = maximum.load( std::memory_order_relaxed );
+			while ( value > current && !maximum.compare_exchange_weak( current, value, std::memory_order_relaxed ) )
+			{
+			}
+		}
+	} // namespace
+
+	//=====================================================================
+	// LeaseAttribution class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Sampling
+	//----------------------------------------------
+
+	void LeaseAttribution::setInterval( uint32_t interval ) noexcept
+	{
+		m_interval.store( interval, std::memory_order_relaxed );
+		setPoolFeature( PoolFeature::Attribution, interval != 0 );
+	}
+
+	uint32_t LeaseAttribution::sample( const std::source_location& location ) noexcept
+	{
+		const uint32_t interval = m_interval.load( std::memory_order_relaxed );
+		if ( interval == 0 )
+		{
+			return 0;
+		}
+
+		if ( t_sampleCountdown == 0 || t_sampleCountdown > interval )
+		{
+			t_sampleCountdown = interval;
+		}
+		if ( --t_sampleCountdown != 0 )
+		{
+			return 0;
+		}
+
+		const uint64_t key = siteKey( location );
+		for ( size_t probe = 0; probe < SITE_CAPACITY; ++probe )
+		{
+			const size_t index = ( key + probe ) & ( SITE_CAPACITY - 1 );
+			Slot& slot = m_slots[index];
+
+			uint64_t slotKey = slot.key.load( std::memory_order_acquire );
+			if ( slotKey == 0 )
+			{
+				if ( slot.key.compare_exchange_strong( slotKey, key, std::memory_order_acq_rel ) )
+				{
+					// Claimed - publish the identity
+					slot.file = location.file_name();
+					slot.function = location.function_name();
+					slot.line = location.line();
+					slot.column = location.column();
+					slot.ready.store( true, std::memory_order_release );
+
+					return static_cast<uint32_t>( index + 1 );
+				}
+				// Lost the race - slotKey now holds the winner's key
+			}
+
+			if ( slotKey == key )
+			{
+				// Wait for the claiming thread to publish the identity, then confirm it
+				while ( !slot.ready.load( std::memory_order_acquire ) )
+				{
+				}
+				if ( slot.line == location.line() && slot.column == location.column() &&
+					 std::strcmp( slot.file, location.file_name() ) == 0 )
+				{
+					return static_cast<uint32_t>( index + 1 );
+				}
+			}
+		}
+
+		m_droppedSamples.fetch_add( 1, std::memory_order_relaxed );
+
+		return 0;
+	}
+
+	void LeaseAttribution::record( uint32_t site, uint64_t size, uint64_t duration ) noexcept
+	{
+		Slot& slot = m_slots[site - 1];
+
+		slot.leases.fetch_add( 1, std::memory_order_relaxed );
+		slot.totalBytes.fetch_add( size, std::memory_order_relaxed );
+		slot.totalNanoseconds.fetch_add( duration, std::memory_order_relaxed );
+		raise( slot.maxBytes, size );
+		raise( slot.maxNanoseconds, duration );
+	}
+
+	//----------------------------------------------
+	// Reporting
+	//----------------------------------------------
+
+	std::vector<StringBuilderPool::LeaseSiteStatistics> LeaseAttribution::sites() const
+	{
+		std::vector<StringBuilderPool::LeaseSiteStatistics> result;
+
+		for ( const Slot& slot : m_slots )
+		{
+			if ( !slot.ready.load( std::memory_order_acquire ) )
+			{
+				continue;
+			}
+
+			result.push_back( StringBuilderPool::LeaseSiteStatistics{
+				.file = slot.file,
+				.function = slot.function,
+				.line = slot.line,
+				.column = slot.column,
+				.sampledLeases = slot.leases.load( std::memory_order_relaxed ),
+				.totalBytes = slot.totalBytes.load( std::memory_order_relaxed ),
+				.maxBytes = slot.maxBytes.load( std::memory_order_relaxed ),
+				.totalNanoseconds = slot.totalNanoseconds.load( std::memory_order_relaxed ),
+				.maxNanoseconds = slot.maxNanoseconds.load( std::memory_order_relaxed ) } );
+		}
+
+		std::sort( result.begin(), result.end(), []( const auto& lhs, const auto& rhs ) {
+			return lhs.totalBytes > rhs.totalBytes;
+		} );
+
+		return result;
+	}
+
+	uint64_t LeaseAttribution::droppedSamples() const noexcept
+	{
+		return m_droppedSamples.load( std::memory_order_relaxed );
+	}
+
+	void LeaseAttribution::reset() noexcept
+	{
+		for ( Slot& slot : m_slots )
+		{
+			slot.leases.store( 0, std::memory_order_relaxed );
+			slot.totalBytes.store( 0, std::memory_order_relaxed );
+			slot.maxBytes.store( 0, std::memory_order_relaxed );
+			slot.totalNanoseconds.store( 0, std::memory_order_relaxed );
+			slot.maxNanoseconds.store( 0, std::memory_order_relaxed );
+		}
+		m_droppedSamples.store( 0, std::memory_order_relaxed );
+	}
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	LeaseAttribution& leaseAttribution() noexcept
+	{
+		static LeaseAttribution attribution;
+
+		return attribution;
+	}
+} // namespace nfx::string
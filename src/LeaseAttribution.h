@@ -0,0 +1,210 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file LeaseAttribution.h
+ * @brief Lock-free per-call-site statistics for sampled leases
+ * @details Internal implementation behind StringBuilderPool::setLeaseSampling() and leaseSites().
+ *
+ * Implementation Notes:
+ * - Sampling: A thread-local countdown selects 1 in N leases, so unsampled leases cost one relaxed
+ *   load and a decrement
+ * - Table: Fixed-size open-addressing table keyed by call site; slots are claimed with a CAS and
+ *   never released, so lookups and updates take no locks
+ * - Overflow: Samples from call sites that find the table full are counted and dropped
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <source_location>
+#include <vector>
+
+#include "nfx/string/StringBuilderPool.h"
+
+namespace nfx::string
+{
+	//=====================================================================
+	// LeaseAttribution class
+	//=====================================================================
+
+	/** @brief Fixed-capacity, lock-free table of lease statistics per call site */
+	class LeaseAttribution final
+	{
+	public:
+		//----------------------------------------------
+		// Constants
+		//----------------------------------------------
+
+		/** @brief Maximum number of distinct call sites tracked (power of two) */
+		static constexpr size_t SITE_CAPACITY = 1024;
+
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+
+		/** @brief Default constructor */
+		LeaseAttribution() = default;
+
+		/** @brief Copy constructor */
+		LeaseAttribution( const LeaseAttribution& ) = delete;
+
+		/** @brief Move constructor */
+		LeaseAttribution( LeaseAttribution&& ) = delete;
+
+		/** @brief Copy assignment operator */
+		LeaseAttribution& operator=( const LeaseAttribution& ) = delete;
+
+		/** @brief Move assignment operator */
+		LeaseAttribution& operator=( LeaseAttribution&& ) = delete;
+
+		//----------------------------------------------
+		// Destruction
+		//----------------------------------------------
+
+		/** @brief Destructor */
+		~LeaseAttribution() = default;
+
+		//----------------------------------------------
+		// Sampling
+		//----------------------------------------------
+
+		/**
+		 * @brief Sets the sampling interval
+		 * @param interval Sample 1 in interval leases, 0 to disable
+		 */
+		void setInterval( uint32_t interval ) noexcept;
+
+		/**
+		 * @brief Gets the sampling interval
+		 * @return Current interval, 0 if disabled
+		 */
+		uint32_t interval() const noexcept
+		{
+			return m_interval.load( std::memory_order_relaxed );
+		}
+
+		/**
+		 * @brief Decides whether the calling thread's current lease is sampled
+		 * @param location Call site of the lease
+		 * @return Site slot for a sampled lease (index + 1), 0 if the lease is not sampled
+		 */
+		uint32_t sample( const std::source_location& location ) noexcept;
+
+		/**
+		 * @brief Records a completed sampled lease
+		 * @param site Value returned by sample()
+		 * @param size Buffer content size at return in bytes
+		 * @param duration Lease hold time in nanoseconds
+		 */
+		void record( uint32_t site, uint64_t size, uint64_t duration ) noexcept;
+
+		//----------------------------------------------
+		// Reporting
+		//----------------------------------------------
+
+		/**
+		 * @brief Copies the statistics of every call site seen so far
+		 * @return Sites ordered by total bytes, largest first
+		 */
+		std::vector<StringBuilderPool::LeaseSiteStatistics> sites() const;
+
+		/**
+		 * @brief Gets number of samples dropped because the table was full
+		 * @return Dropped sample count
+		 */
+		uint64_t droppedSamples() const noexcept;
+
+		/** @brief Zeroes the statistics of every site, keeping the sites themselves */
+		void reset() noexcept;
+
+	private:
+		//----------------------------------------------
+		// Slot structure
+		//----------------------------------------------
+
+		/** @brief Statistics of one call site */
+		struct Slot
+		{
+			/** @brief Call site identity hash, 0 while the slot is free */
+			std::atomic<uint64_t> key{ 0 };
+
+			/** @brief Set once the identity fields below are published */
+			std::atomic<bool> ready{ false };
+
+			/** @brief Source file of the call site */
+			const char* file{ nullptr };
+
+			/** @brief Enclosing function of the call site */
+			const char* function{ nullptr };
+
+			/** @brief Line of the call site */
+			uint32_t line{ 0 };
+
+			/** @brief Column of the call site */
+			uint32_t column{ 0 };
+
+			/** @brief Number of sampled leases */
+			std::atomic<uint64_t> leases{ 0 };
+
+			/** @brief Sum of buffer sizes at return */
+			std::atomic<uint64_t> totalBytes{ 0 };
+
+			/** @brief Largest buffer size at return */
+			std::atomic<uint64_t> maxBytes{ 0 };
+
+			/** @brief Sum of lease hold times in nanoseconds */
+			std::atomic<uint64_t> totalNanoseconds{ 0 };
+
+			/** @brief Longest lease hold time in nanoseconds */
+			std::atomic<uint64_t> maxNanoseconds{ 0 };
+		};
+
+		//----------------------------------------------
+		// Private member variables
+		//----------------------------------------------
+
+		/** @brief Call site slots */
+		std::array<Slot, SITE_CAPACITY> m_slots;
+
+		/** @brief Sampling interval, 0 when disabled */
+		std::atomic<uint32_t> m_interval{ 0 };
+
+		/** @brief Samples dropped because no slot was available */
+		std::atomic<uint64_t> m_droppedSamples{ 0 };
+	};
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	/**
+	 * @brief Gets the process-wide LeaseAttribution instance
+	 * @return Reference to the global call site table
+	 * @details Defined out of line so that every translation unit shares one instance
+	 */
+	LeaseAttribution& leaseAttribution() noexcept;
+} // namespace nfx::string
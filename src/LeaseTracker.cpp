@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file LeaseTracker.cpp
+ * @brief Implementation of outstanding lease tracking
+ */
+
+#include <algorithm>
+#include <new>
+
+#include "LeaseTracker.h"
+#include "PoolHistograms.h"
+
+namespace nfx::string
+{
+	//=====================================================================
+	// LeaseTracker class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Tracking
+	//----------------------------------------------
+
+	void LeaseTracker::setEnabled( bool enabled ) noexcept
+	{
+		setPoolFeature( PoolFeature::LeaseTracking, enabled );
+	}
+
+	void LeaseTracker::track( const DynamicStringBuffer* buffer, const std::source_location& location ) noexcept
+	{
+		const Record record{ location, PoolHistograms::now(), std::this_thread::get_id() };
+
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		try
+		{
+			m_records.insert_or_assign( buffer, record );
+			m_outstanding.store( m_records.size(), std::memory_order_relaxed );
+			setPoolFeature( PoolFeature::TrackedLeases, true );
+		}
+		catch ( const std::bad_alloc& )
+		{
+			// Leave the lease untracked rather than fail it
+		}
+	}
+
+	void LeaseTracker::release( const DynamicStringBuffer* buffer ) noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		if ( m_records.erase( buffer ) != 0 )
+		{
+			m_outstanding.store( m_records.size(), std::memory_order_relaxed );
+			if ( m_records.empty() )
+			{
+				setPoolFeature( PoolFeature::TrackedLeases, false );
+			}
+		}
+	}
+
+	//----------------------------------------------
+	// Reporting
+	//----------------------------------------------
+
+	std::vector<StringBuilderPool::OutstandingLease> LeaseTracker::leases( uint64_t minimumAge ) const
+	{
+		const uint64_t now = PoolHistograms::now();
+		std::vector<StringBuilderPool::OutstandingLease> result;
+
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			for ( const auto& entry : m_records )
+			{
+				const Record& record = entry.second;
+				const uint64_t age = now > record.start ? now - record.start : 0;
+				if ( age < minimumAge )
+				{
+					continue;
+				}
+
+				result.push_back( {
+					record.location.file_name(),
+					record.location.function_name(),
+					record.location.line(),
+					record.location.column(),
+					record.thread,
+					age } );
+			}
+		}
+
+		std::sort( result.begin(), result.end(), []( const auto& a, const auto& b ) { return a.ageNanoseconds > b.ageNanoseconds; } );
+
+		return result;
+	}
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	LeaseTracker& leaseTracker() noexcept
+	{
+		static LeaseTracker tracker;
+
+		return tracker;
+	}
+} // namespace nfx::string
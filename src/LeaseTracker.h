@@ -0,0 +1,193 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file LeaseTracker.h
+ * @brief Registry of outstanding leases for finding buffer hoarding
+ * @details Internal implementation behind StringBuilderPool::setLeaseTracking() and outstandingLeases().
+ *
+ * Implementation Notes:
+ * - Tracking: Each lease taken while enabled is recorded with its call site, start time and thread
+ *   in a mutex-protected map keyed by buffer; returning the buffer erases it
+ * - Draining: Disabling stops new records, but leases already recorded are still erased on return
+ *   until the map is empty, so the outstanding count never goes stale
+ * - Opt-in: Disabled by default, since every tracked lease and return serializes on one mutex
+ *   and the map allocates a node per lease
+ * - Cost: None beyond the shared PoolFeature mask test while disabled and empty
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "PoolFeatures.h"
+#include "nfx/string/StringBuilderPool.h"
+
+namespace nfx::string
+{
+	//=====================================================================
+	// LeaseTracker class
+	//=====================================================================
+
+	/** @brief Mutex-protected map of leased buffers to their call site, start time and thread */
+	class LeaseTracker final
+	{
+	public:
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+
+		/** @brief Default constructor, tracking disabled */
+		LeaseTracker() = default;
+
+		/** @brief Copy constructor */
+		LeaseTracker( const LeaseTracker& ) = delete;
+
+		/** @brief Move constructor */
+		LeaseTracker( LeaseTracker&& ) = delete;
+
+		/** @brief Copy assignment operator */
+		LeaseTracker& operator=( const LeaseTracker& ) = delete;
+
+		/** @brief Move assignment operator */
+		LeaseTracker& operator=( LeaseTracker&& ) = delete;
+
+		//----------------------------------------------
+		// Destruction
+		//----------------------------------------------
+
+		/** @brief Destructor */
+		~LeaseTracker() = default;
+
+		//----------------------------------------------
+		// Tracking
+		//----------------------------------------------
+
+		/**
+		 * @brief Checks if new leases are recorded
+		 * @return true if tracking is enabled
+		 */
+		bool isEnabled() const noexcept
+		{
+			return ( poolFeatures() & PoolFeature::LeaseTracking ) != 0;
+		}
+
+		/**
+		 * @brief Enables or disables recording of new leases
+		 * @param enabled New state
+		 */
+		void setEnabled( bool enabled ) noexcept;
+
+		/**
+		 * @brief Checks if any lease is recorded
+		 * @return true if a returned buffer may need to be erased
+		 */
+		bool hasOutstanding() const noexcept
+		{
+			return ( poolFeatures() & PoolFeature::TrackedLeases ) != 0;
+		}
+
+		/**
+		 * @brief Records a new lease
+		 * @param buffer Leased buffer
+		 * @param location Call site of the lease
+		 * @details A lease that cannot be recorded for lack of memory is left out of the registry.
+		 */
+		void track( const DynamicStringBuffer* buffer, const std::source_location& location ) noexcept;
+
+		/**
+		 * @brief Erases the record of a returned buffer, if any
+		 * @param buffer Buffer being returned to the pool
+		 */
+		void release( const DynamicStringBuffer* buffer ) noexcept;
+
+		//----------------------------------------------
+		// Reporting
+		//----------------------------------------------
+
+		/**
+		 * @brief Gets number of recorded leases not yet returned
+		 * @return Outstanding lease count
+		 */
+		size_t outstandingCount() const noexcept
+		{
+			return m_outstanding.load( std::memory_order_relaxed );
+		}
+
+		/**
+		 * @brief Copies the recorded leases held at least a given time
+		 * @param minimumAge Minimum age in nanoseconds
+		 * @return Matching leases, oldest first
+		 */
+		std::vector<StringBuilderPool::OutstandingLease> leases( uint64_t minimumAge ) const;
+
+	private:
+		//----------------------------------------------
+		// Record structure
+		//----------------------------------------------
+
+		/** @brief Origin of one outstanding lease */
+		struct Record
+		{
+			/** @brief Call site of the lease */
+			std::source_location location;
+
+			/** @brief Steady-clock time the lease started in nanoseconds */
+			uint64_t start;
+
+			/** @brief Thread that took the lease */
+			std::thread::id thread;
+		};
+
+		//----------------------------------------------
+		// Private member variables
+		//----------------------------------------------
+
+		/** @brief Outstanding leases by buffer */
+		std::unordered_map<const DynamicStringBuffer*, Record> m_records;
+
+		/** @brief Mutex protecting m_records */
+		mutable std::mutex m_mutex;
+
+		/** @brief Number of entries in m_records, readable without the mutex */
+		std::atomic<size_t> m_outstanding{ 0 };
+	};
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	/**
+	 * @brief Gets the process-wide LeaseTracker instance
+	 * @return Reference to the global outstanding lease registry
+	 * @details Defined out of line so that every translation unit shares one instance
+	 */
+	LeaseTracker& leaseTracker() noexcept;
+} // namespace nfx::string
@@ -0,0 +1,251 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file OpenMetricsExporter.cpp
+ * @brief OpenMetrics text exposition of StringBuilderPool statistics
+ * @details Families are written contiguously with one sample per pool label value, as the
+ *          OpenMetrics text format requires.
+ */
+
+#include <array>
+#include <charconv>
+
+#include "nfx/string/StringBuilderPool.h"
+
+namespace nfx::string
+{
+	namespace
+	{
+		//=====================================================================
+		// Constants
+		//=====================================================================
+
+		/** @brief Common prefix of all exported metric families */
+		constexpr std::string_view METRIC_PREFIX = "nfx_stringbuilderpool_";
+
+		/** @brief Nanoseconds per second */
+		constexpr double NANOSECONDS_PER_SECOND = 1e9;
+
+		//=====================================================================
+		// Formatting helpers
+		//=====================================================================
+
+		void appendNumber( StringBuilder& builder, uint64_t value )
+		{
+			std::array<char, 24> digits;
+			const auto result = std::to_chars( digits.data(), digits.data() + digits.size(), value );
+			builder.append( std::string_view{ digits.data(), static_cast<size_t>( result.ptr - digits.data() ) } );
+		}
+
+		void appendNumber( StringBuilder& builder, double value )
+		{
+			std::array<char, 32> digits;
+			const auto result = std::to_chars( digits.data(), digits.data() + digits.size(), value );
+			builder.append( std::string_view{ digits.data(), static_cast<size_t>( result.ptr - digits.data() ) } );
+		}
+
+		/** @brief Appends a label value, escaping backslash, double quote and line feed */
+		void appendLabelValue( StringBuilder& builder, std::string_view value )
+		{
+			for ( const char c : value )
+			{
+				switch ( c )
+				{
+					case '\\':
+					{
+						builder << "\\\\";
+						break;
+					}
+					case '"':
+					{
+						builder << "\\\"";
+						break;
+					}
+					case '\n':
+					{
+						builder << "\\n";
+						break;
+					}
+					default:
+					{
+						builder << c;
+						break;
+					}
+				}
+			}
+		}
+
+		void appendFamilyHeader(
+			StringBuilder& builder, std::string_view name, std::string_view type,
+			std::string_view unit, std::string_view help )
+		{
+			builder << "# TYPE " << METRIC_PREFIX << name << ' ' << type << '\n';
+			if ( !unit.empty() )
+			{
+				builder << "# UNIT " << METRIC_PREFIX << name << ' ' << unit << '\n';
+			}
+			builder << "# HELP " << METRIC_PREFIX << name << ' ' << help << '\n';
+		}
+
+		/** @brief Appends "prefix+name+suffix{pool="..."" leaving the label set open */
+		void appendSampleStart(
+			StringBuilder& builder, std::string_view name, std::string_view suffix, std::string_view pool )
+		{
+			builder << METRIC_PREFIX << name << suffix << "{pool=\"";
+			appendLabelValue( builder, pool );
+			builder << '"';
+		}
+
+		//=====================================================================
+		// Metric families
+		//=====================================================================
+
+		void writeCounter(
+			StringBuilder& builder, std::span<const StringBuilderPool::MetricsSource> sources,
+			std::string_view name, std::string_view unit, std::string_view help,
+			uint64_t StringBuilderPool::PoolStatistics::* field )
+		{
+			appendFamilyHeader( builder, name, "counter", unit, help );
+			for ( const auto& source : sources )
+			{
+				appendSampleStart( builder, name, "_total", source.name );
+				builder << "} ";
+				appendNumber( builder, source.statistics.*field );
+				builder << '\n';
+			}
+		}
+
+		void writeHitRate( StringBuilder& builder, std::span<const StringBuilderPool::MetricsSource> sources )
+		{
+			appendFamilyHeader( builder, "hit_ratio", "gauge", "ratio",
+				"Fraction of buffer requests served from the thread-local cache or shared pool." );
+			for ( const auto& source : sources )
+			{
+				appendSampleStart( builder, "hit_ratio", "", source.name );
+				builder << "} ";
+				appendNumber( builder, source.statistics.hitRate );
+				builder << '\n';
+			}
+		}
+
+		/**
+		 * @brief Writes a histogram family with le buckets at 2^k - 1 for k in [0, maxExponent]
+		 * @details The bounds fall on octave boundaries of the log-linear histogram, so the cumulative
+		 *          counts are exact for integer-valued recordings.
+		 */
+		void writeHistogram(
+			StringBuilder& builder, std::span<const StringBuilderPool::MetricsSource> sources,
+			std::string_view name, std::string_view unit, std::string_view help,
+			StringBuilderPool::Histogram StringBuilderPool::PoolStatistics::* field,
+			double divisor, size_t maxExponent )
+		{
+			using Histogram = StringBuilderPool::Histogram;
+
+			appendFamilyHeader( builder, name, "histogram", unit, help );
+			for ( const auto& source : sources )
+			{
+				const Histogram& histogram = source.statistics.*field;
+
+				uint64_t cumulative = 0;
+				size_t nextBucket = 0;
+				for ( size_t exponent = 0; exponent <= maxExponent; ++exponent )
+				{
+					const uint64_t bound = ( uint64_t{ 1 } << exponent ) - 1;
+					const size_t lastBucket = Histogram::bucketIndex( bound );
+					for ( ; nextBucket <= lastBucket; ++nextBucket )
+					{
+						cumulative += histogram.buckets[nextBucket];
+					}
+
+					appendSampleStart( builder, name, "_bucket", source.name );
+					builder << ",le=\"";
+					appendNumber( builder, static_cast<double>( bound ) / divisor );
+					builder << "\"} ";
+					appendNumber( builder, cumulative );
+					builder << '\n';
+				}
+
+				appendSampleStart( builder, name, "_bucket", source.name );
+				builder << ",le=\"+Inf\"} ";
+				appendNumber( builder, histogram.count );
+				builder << '\n';
+
+				appendSampleStart( builder, name, "_count", source.name );
+				builder << "} ";
+				appendNumber( builder, histogram.count );
+				builder << '\n';
+
+				appendSampleStart( builder, name, "_sum", source.name );
+				builder << "} ";
+				appendNumber( builder, static_cast<double>( histogram.sum ) / divisor );
+				builder << '\n';
+			}
+		}
+	} // namespace
+
+	//=====================================================================
+	// StringBuilderPool class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Metrics export
+	//----------------------------------------------
+
+	void StringBuilderPool::exportOpenMetrics( StringBuilder& builder, std::string_view poolName )
+	{
+		const PoolStatistics statistics = stats();
+		const std::array<MetricsSource, 1> sources{ { { poolName, statistics } } };
+
+		exportOpenMetrics( builder, sources );
+	}
+
+	void StringBuilderPool::exportOpenMetrics( StringBuilder& builder, std::span<const MetricsSource> sources )
+	{
+		using Statistics = PoolStatistics;
+
+		writeCounter( builder, sources, "requests", "", "Buffer requests made to the pool.", &Statistics::totalRequests );
+		writeCounter( builder, sources, "thread_local_hits", "", "Requests served from the thread-local cache.", &Statistics::threadLocalHits );
+		writeCounter( builder, sources, "shared_pool_hits", "", "Requests served from the shared pool.", &Statistics::dynamicStringBufferPoolHits );
+		writeCounter( builder, sources, "new_allocations", "", "Requests that allocated a new buffer.", &Statistics::newAllocations );
+		writeCounter( builder, sources, "thread_local_parks", "", "Returned buffers kept in a thread-local cache.", &Statistics::threadLocalParks );
+		writeCounter( builder, sources, "shared_pool_parks", "", "Returned buffers kept in the shared pool.", &Statistics::sharedPoolParks );
+		writeCounter( builder, sources, "oversize_shrinks", "", "Oversized returned buffers shrunk to the initial capacity.", &Statistics::oversizeShrinks );
+		writeCounter( builder, sources, "oversize_discards", "", "Oversized returned buffers deleted.", &Statistics::oversizeDiscards );
+		writeCounter( builder, sources, "pool_full_discards", "", "Returned buffers deleted because the shared pool was full.", &Statistics::poolFullDiscards );
+		writeCounter( builder, sources, "growths", "", "Buffer capacity growths.", &Statistics::heapGrowths );
+		writeCounter( builder, sources, "growth_copied_bytes", "bytes", "Bytes copied by reallocating growths.", &Statistics::bytesCopiedOnGrowth );
+
+		writeHitRate( builder, sources );
+
+		writeHistogram( builder, sources, "lease_duration_seconds", "seconds", "Lease hold time.",
+			&Statistics::leaseDuration, NANOSECONDS_PER_SECOND, 40 );
+		writeHistogram( builder, sources, "buffer_size_bytes", "bytes", "Buffer content size when the lease ends.",
+			&Statistics::bufferSize, 1.0, 32 );
+		writeHistogram( builder, sources, "lease_growths", "", "Capacity growths per lease.",
+			&Statistics::growthEvents, 1.0, 16 );
+
+		builder << "# EOF\n";
+	}
+} // namespace nfx::string
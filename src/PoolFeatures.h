@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PoolFeatures.h
+ * @brief Process-wide mask of the optional per-lease instrumentation that is switched on
+ * @details The lease and return paths load the mask once and skip every subsystem whose bit is
+ *          clear, so the instrumentation singletons are only reached while they have work to do.
+ *          Each subsystem keeps its own bit in step with its enable switch.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace nfx::string
+{
+	//=====================================================================
+	// Pool feature mask
+	//=====================================================================
+
+	/** @brief Bits of g_poolFeatures */
+	namespace PoolFeature
+	{
+		/** @brief Lease duration, size and growth histograms (PoolHistograms) */
+		inline constexpr uint32_t Histograms = 1u << 0;
+
+		/** @brief Sampled call site attribution (LeaseAttribution) */
+		inline constexpr uint32_t Attribution = 1u << 1;
+
+		/** @brief Binary trace recording (PoolTraceRecorder) */
+		inline constexpr uint32_t Trace = 1u << 2;
+
+		/** @brief Recording of new outstanding leases (LeaseTracker) */
+		inline constexpr uint32_t LeaseTracking = 1u << 3;
+
+		/** @brief At least one lease is recorded and must be erased on return (LeaseTracker) */
+		inline constexpr uint32_t TrackedLeases = 1u << 4;
+	} // namespace PoolFeature
+
+	/** @brief Enabled PoolFeature bits, constant-initialized and shared by all translation units */
+	constinit inline std::atomic<uint32_t> g_poolFeatures{ 0 };
+
+	/**
+	 * @brief Loads the enabled feature bits
+	 * @return Current PoolFeature mask
+	 */
+	inline uint32_t poolFeatures() noexcept
+	{
+		return g_poolFeatures.load( std::memory_order_relaxed );
+	}
+
+	/**
+	 * @brief Sets or clears one feature bit
+	 * @param feature PoolFeature bit
+	 * @param enabled New state
+	 */
+	inline void setPoolFeature( uint32_t feature, bool enabled ) noexcept
+	{
+		if ( enabled )
+		{
+			g_poolFeatures.fetch_or( feature, std::memory_order_relaxed );
+		}
+		else
+		{
+			g_poolFeatures.fetch_and( ~feature, std::memory_order_relaxed );
+		}
+	}
+} // namespace nfx::string
@@ -0,0 +1,213 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PoolHistograms.cpp
+ * @brief Implementation of per-thread lease histograms
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "PoolHistograms.h"
+
+namespace nfx::string
+{
+	namespace
+	{
+		//=====================================================================
+		// Thread-local histogram record
+		//=====================================================================
+
+		/** @brief Owns the calling thread's record and retires it on thread exit */
+		struct ThreadRecordOwner
+		{
+			~ThreadRecordOwner()
+			{
+				if ( record )
+				{
+					poolHistograms().retireThread( record.get() );
+				}
+			}
+
+			/** @brief Record, allocated on the thread's first recorded lease */
+			std::unique_ptr<PoolHistograms::ThreadRecord> record;
+		};
+
+		/** @brief Calling thread's histogram record */
+		thread_local ThreadRecordOwner t_histogramRecord;
+
+		/** @brief Single-writer increment - a relaxed load and store, no locked instruction */
+		void bump( std::atomic<uint64_t>& counter, uint64_t delta ) noexcept
+		{
+			counter.store( counter.load( std::memory_order_relaxed ) + delta, std::memory_order_relaxed );
+		}
+	} // namespace
+
+	//=====================================================================
+	// PoolHistograms class
+	//=====================================================================
+
+	//----------------------------------------------
+	// AtomicHistogram struct
+	//----------------------------------------------
+
+	void PoolHistograms::AtomicHistogram::record( uint64_t value ) noexcept
+	{
+		bump( buckets[StringBuilderPool::Histogram::bucketIndex( value )], 1 );
+		bump( count, 1 );
+		bump( sum, value );
+		if ( value > max.load( std::memory_order_relaxed ) )
+		{
+			max.store( value, std::memory_order_relaxed );
+		}
+	}
+
+	void PoolHistograms::AtomicHistogram::addTo( StringBuilderPool::Histogram& histogram ) const noexcept
+	{
+		for ( size_t i = 0; i < buckets.size(); ++i )
+		{
+			histogram.buckets[i] += buckets[i].load( std::memory_order_relaxed );
+		}
+		histogram.count += count.load( std::memory_order_relaxed );
+		histogram.sum += sum.load( std::memory_order_relaxed );
+		histogram.max = std::max( histogram.max, max.load( std::memory_order_relaxed ) );
+	}
+
+	void PoolHistograms::AtomicHistogram::reset() noexcept
+	{
+		for ( auto& bucket : buckets )
+		{
+			bucket.store( 0, std::memory_order_relaxed );
+		}
+		count.store( 0, std::memory_order_relaxed );
+		sum.store( 0, std::memory_order_relaxed );
+		max.store( 0, std::memory_order_relaxed );
+	}
+
+	//----------------------------------------------
+	// Recording
+	//----------------------------------------------
+
+	void PoolHistograms::setEnabled( bool enabled ) noexcept
+	{
+		setPoolFeature( PoolFeature::Histograms, enabled );
+	}
+
+	void PoolHistograms::recordLease( uint64_t duration, uint64_t size, uint64_t growths )
+	{
+		auto& owner = t_histogramRecord;
+		if ( !owner.record )
+		{
+			owner.record = std::make_unique<ThreadRecord>();
+			registerThread( owner.record.get() );
+		}
+
+		owner.record->leaseDuration.record( duration );
+		owner.record->bufferSize.record( size );
+		owner.record->growthEvents.record( growths );
+	}
+
+	uint64_t PoolHistograms::now() noexcept
+	{
+		const auto ticks = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch() )
+							   .count();
+
+		// 0 marks an unsampled lease
+		return static_cast<uint64_t>( ticks ) | 1;
+	}
+
+	//----------------------------------------------
+	// Aggregation
+	//----------------------------------------------
+
+	void PoolHistograms::snapshot(
+		StringBuilderPool::Histogram& leaseDuration,
+		StringBuilderPool::Histogram& bufferSize,
+		StringBuilderPool::Histogram& growthEvents ) const noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
+		leaseDuration = m_retiredLeaseDuration;
+		bufferSize = m_retiredBufferSize;
+		growthEvents = m_retiredGrowthEvents;
+
+		for ( const auto* record : m_threads )
+		{
+			record->leaseDuration.addTo( leaseDuration );
+			record->bufferSize.addTo( bufferSize );
+			record->growthEvents.addTo( growthEvents );
+		}
+	}
+
+	void PoolHistograms::reset() noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
+		m_retiredLeaseDuration = {};
+		m_retiredBufferSize = {};
+		m_retiredGrowthEvents = {};
+
+		for ( auto* record : m_threads )
+		{
+			record->leaseDuration.reset();
+			record->bufferSize.reset();
+			record->growthEvents.reset();
+		}
+	}
+
+	//----------------------------------------------
+	// Thread registry
+	//----------------------------------------------
+
+	void PoolHistograms::registerThread( ThreadRecord* record )
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		m_threads.push_back( record );
+	}
+
+	void PoolHistograms::retireThread( ThreadRecord* record ) noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
+		record->leaseDuration.addTo( m_retiredLeaseDuration );
+		record->bufferSize.addTo( m_retiredBufferSize );
+		record->growthEvents.addTo( m_retiredGrowthEvents );
+
+		std::erase( m_threads, record );
+	}
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	PoolHistograms& poolHistograms() noexcept
+	{
+		static PoolHistograms histograms;
+
+		return histograms;
+	}
+} // namespace nfx::string
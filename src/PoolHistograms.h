@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PoolHistograms.h
+ * @brief Per-thread lease histograms merged on demand
+ * @details Internal implementation behind the histogram fields of StringBuilderPool::PoolStatistics.
+ *
+ * Implementation Notes:
+ * - Recording: Each thread owns a record of relaxed atomics that only it writes, so recording
+ *   is a handful of plain loads and stores with no read-modify-write or locking
+ * - Registry: Records register on first use; snapshot() sums them under the registry mutex
+ * - Thread exit: A thread's record is merged into the retired totals and unregistered
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "PoolFeatures.h"
+#include "nfx/string/StringBuilderPool.h"
+
+namespace nfx::string
+{
+	//=====================================================================
+	// PoolHistograms class
+	//=====================================================================
+
+	/**
+	 * @brief Registry of per-thread lease duration, buffer size and growth histograms
+	 * @details Recording is off until enabled at runtime, leaving only the shared PoolFeature
+	 *          mask test on the lease path. Resetting while other threads record may lose their in-flight updates.
+	 */
+	class PoolHistograms final
+	{
+	public:
+		//----------------------------------------------
+		// Types
+		//----------------------------------------------
+
+		/** @brief Histogram storage written by a single thread and read by any */
+		struct AtomicHistogram
+		{
+			/**
+			 * @brief Records a value (owning thread only)
+			 * @param value Value to record
+			 */
+			void record( uint64_t value ) noexcept;
+
+			/**
+			 * @brief Adds the recorded values to a histogram
+			 * @param histogram Destination histogram
+			 */
+			void addTo( StringBuilderPool::Histogram& histogram ) const noexcept;
+
+			/** @brief Zeroes all recorded values */
+			void reset() noexcept;
+
+			/** @brief Number of values recorded in each bucket */
+			std::array<std::atomic<uint64_t>, StringBuilderPool::Histogram::BUCKET_COUNT> buckets{};
+
+			/** @brief Number of recorded values */
+			std::atomic<uint64_t> count{ 0 };
+
+			/** @brief Sum of recorded values */
+			std::atomic<uint64_t> sum{ 0 };
+
+			/** @brief Largest recorded value */
+			std::atomic<uint64_t> max{ 0 };
+		};
+
+		/** @brief Histograms recorded by one thread */
+		struct ThreadRecord
+		{
+			/** @brief Lease hold time in nanoseconds */
+			AtomicHistogram leaseDuration;
+
+			/** @brief Buffer content size at return in bytes */
+			AtomicHistogram bufferSize;
+
+			/** @brief Capacity growths per lease */
+			AtomicHistogram growthEvents;
+		};
+
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+
+		/** @brief Default constructor */
+		PoolHistograms() = default;
+
+		/** @brief Copy constructor */
+		PoolHistograms( const PoolHistograms& ) = delete;
+
+		/** @brief Move constructor */
+		PoolHistograms( PoolHistograms&& ) = delete;
+
+		/** @brief Copy assignment operator */
+		PoolHistograms& operator=( const PoolHistograms& ) = delete;
+
+		/** @brief Move assignment operator */
+		PoolHistograms& operator=( PoolHistograms&& ) = delete;
+
+		//----------------------------------------------
+		// Destruction
+		//----------------------------------------------
+
+		/** @brief Destructor */
+		~PoolHistograms() = default;
+
+		//----------------------------------------------
+		// Recording
+		//----------------------------------------------
+
+		/**
+		 * @brief Checks if recording is enabled
+		 * @return true if leases should be timed and recorded
+		 */
+		bool isEnabled() const noexcept
+		{
+			return ( poolFeatures() & PoolFeature::Histograms ) != 0;
+		}
+
+		/**
+		 * @brief Enables or disables recording
+		 * @param enabled New state
+		 */
+		void setEnabled( bool enabled ) noexcept;
+
+		/**
+		 * @brief Records one completed lease into the calling thread's histograms
+		 * @param duration Lease hold time in nanoseconds
+		 * @param size Buffer content size at return in bytes
+		 * @param growths Capacity growths during the lease
+		 */
+		void recordLease( uint64_t duration, uint64_t size, uint64_t growths );
+
+		/**
+		 * @brief Gets current steady-clock time for lease timestamps
+		 * @return Nanoseconds since the steady clock epoch, never 0
+		 */
+		static uint64_t now() noexcept;
+
+		//----------------------------------------------
+		// Aggregation
+		//----------------------------------------------
+
+		/**
+		 * @brief Sums retired and live thread histograms
+		 * @param leaseDuration Receives lease durations
+		 * @param bufferSize Receives buffer sizes
+		 * @param growthEvents Receives growth counts
+		 */
+		void snapshot(
+			StringBuilderPool::Histogram& leaseDuration,
+			StringBuilderPool::Histogram& bufferSize,
+			StringBuilderPool::Histogram& growthEvents ) const noexcept;
+
+		/** @brief Zeroes retired and live thread histograms */
+		void reset() noexcept;
+
+		//----------------------------------------------
+		// Thread registry
+		//----------------------------------------------
+
+		/**
+		 * @brief Registers a thread's record
+		 * @param record Record owned by the calling thread
+		 */
+		void registerThread( ThreadRecord* record );
+
+		/**
+		 * @brief Merges a thread's record into the retired totals and unregisters it
+		 * @param record Record owned by the exiting thread
+		 */
+		void retireThread( ThreadRecord* record ) noexcept;
+
+	private:
+		//----------------------------------------------
+		// Private member variables
+		//----------------------------------------------
+
+		/** @brief Mutex protecting the registry and retired totals */
+		mutable std::mutex m_mutex;
+
+		/** @brief Records of live threads */
+		std::vector<ThreadRecord*> m_threads;
+
+		/** @brief Lease durations recorded by exited threads */
+		StringBuilderPool::Histogram m_retiredLeaseDuration{};
+
+		/** @brief Buffer sizes recorded by exited threads */
+		StringBuilderPool::Histogram m_retiredBufferSize{};
+
+		/** @brief Growth counts recorded by exited threads */
+		StringBuilderPool::Histogram m_retiredGrowthEvents{};
+	};
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	/**
+	 * @brief Gets the process-wide PoolHistograms instance
+	 * @return Reference to the global histogram registry
+	 * @details Defined out of line so that every translation unit shares one instance
+	 */
+	PoolHistograms& poolHistograms() noexcept;
+} // namespace nfx::string
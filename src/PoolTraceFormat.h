@@ -0,0 +1,114 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PoolTraceFormat.h
+ * @brief Binary layout of pool lease traces
+ * @details Shared by the trace recorder and the offline pool simulator (tools/).
+ *
+ * File Layout:
+ * - PoolTraceHeader (24 bytes), magic "NFXPTRC\0", version and record size
+ * - PoolTraceRecord (24 bytes) repeated until end of file, in recording order
+ * - All integers are in the byte order of the recording machine (little-endian on supported targets)
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace nfx::string
+{
+	//=====================================================================
+	// Trace file format
+	//=====================================================================
+
+	/** @brief File magic identifying a pool trace */
+	inline constexpr std::array<char, 8> POOL_TRACE_MAGIC{ 'N', 'F', 'X', 'P', 'T', 'R', 'C', '\0' };
+
+	/** @brief Current trace format version */
+	inline constexpr uint32_t POOL_TRACE_VERSION = 1;
+
+	/** @brief Kind of a trace record */
+	enum class PoolTraceEvent : uint8_t
+	{
+		/** @brief Buffer handed out by the pool, size is 0 */
+		Lease = 1,
+
+		/** @brief Buffer given back to the pool, size is its content size */
+		Return = 2,
+	};
+
+	/** @brief Bits of PoolTraceRecord::flags */
+	namespace PoolTraceFlag
+	{
+		/**
+		 * @brief Return bypassed the releasing thread's cache for the shared pool
+		 * @details Set when an asyncLease() buffer is released on a thread other than the one that
+		 *          leased it.
+		 */
+		inline constexpr uint8_t SharedPool = 1u << 0;
+	} // namespace PoolTraceFlag
+
+	/** @brief Trace file header */
+	struct PoolTraceHeader
+	{
+		/** @brief POOL_TRACE_MAGIC */
+		std::array<char, 8> magic;
+
+		/** @brief POOL_TRACE_VERSION */
+		uint32_t version;
+
+		/** @brief sizeof( PoolTraceRecord ) when written */
+		uint32_t recordSize;
+
+		/** @brief Steady-clock time at which recording started, in nanoseconds */
+		uint64_t startTime;
+	};
+
+	/** @brief One lease or return event */
+	struct PoolTraceRecord
+	{
+		/** @brief Nanoseconds since PoolTraceHeader::startTime */
+		uint64_t timestamp;
+
+		/** @brief Opaque buffer identity pairing a Lease with its Return */
+		uint64_t buffer;
+
+		/** @brief Buffer content size for Return events */
+		uint32_t size;
+
+		/** @brief Recording thread index, in order of each thread's first event */
+		uint16_t thread;
+
+		/** @brief PoolTraceEvent value */
+		uint8_t event;
+
+		/** @brief PoolTraceFlag bits, zero for Lease events */
+		uint8_t flags;
+	};
+
+	static_assert( sizeof( PoolTraceHeader ) == 24, "PoolTraceHeader layout changed" );
+	static_assert( sizeof( PoolTraceRecord ) == 24, "PoolTraceRecord layout changed" );
+} // namespace nfx::string
@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PoolTraceRecorder.cpp
+ * @brief Implementation of the pool trace recorder
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+#include "PoolTraceRecorder.h"
+
+namespace nfx::string
+{
+	namespace
+	{
+		//=====================================================================
+		// Thread indices
+		//=====================================================================
+
+		/** @brief Next thread index to hand out */
+		std::atomic<uint16_t> g_nextThreadIndex{ 0 };
+
+		/** @brief Calling thread's index plus one, 0 until its first event */
+		thread_local uint32_t t_threadIndex = 0;
+
+		uint16_t threadIndex() noexcept
+		{
+			if ( t_threadIndex == 0 )
+			{
+				t_threadIndex = uint32_t{ g_nextThreadIndex.fetch_add( 1, std::memory_order_relaxed ) } + 1;
+			}
+
+			return static_cast<uint16_t>( t_threadIndex - 1 );
+		}
+
+		uint64_t steadyNanoseconds() noexcept
+		{
+			return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch() )
+					.count() );
+		}
+	} // namespace
+
+	//=====================================================================
+	// PoolTraceRecorder class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Destruction
+	//----------------------------------------------
+
+	PoolTraceRecorder::~PoolTraceRecorder()
+	{
+		stop();
+	}
+
+	//----------------------------------------------
+	// Session control
+	//----------------------------------------------
+
+	void PoolTraceRecorder::start( const std::string& path )
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		if ( m_file )
+		{
+			throw std::logic_error{ "A pool trace is already being recorded" };
+		}
+
+		// Allocate before opening, so a bad_alloc neither leaks the handle nor leaves a stray file
+		m_pending.reserve( BLOCK_RECORDS );
+
+		std::FILE* file = std::fopen( path.c_str(), "wb" );
+		if ( !file )
+		{
+			throw std::runtime_error{ "Cannot open pool trace file: " + path };
+		}
+
+		m_startTime = steadyNanoseconds();
+		const PoolTraceHeader header{
+			.magic = POOL_TRACE_MAGIC,
+			.version = POOL_TRACE_VERSION,
+			.recordSize = sizeof( PoolTraceRecord ),
+			.startTime = m_startTime };
+		if ( std::fwrite( &header, sizeof( header ), 1, file ) != 1 )
+		{
+			std::fclose( file );
+			throw std::runtime_error{ "Cannot write pool trace file: " + path };
+		}
+
+		m_file = file;
+		m_recordCount = 0;
+		setPoolFeature( PoolFeature::Trace, true );
+	}
+
+	uint64_t PoolTraceRecorder::stop() noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+
+		return close();
+	}
+
+	//----------------------------------------------
+	// Recording
+	//----------------------------------------------
+
+	void PoolTraceRecorder::record( PoolTraceEvent event, const void* buffer, size_t size, uint8_t flags ) noexcept
+	{
+		const uint16_t thread = threadIndex();
+
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		if ( !m_file )
+		{
+			return;
+		}
+
+		m_pending.push_back( PoolTraceRecord{
+			.timestamp = steadyNanoseconds() - m_startTime,
+			.buffer = reinterpret_cast<uintptr_t>( buffer ),
+			.size = static_cast<uint32_t>( std::min<size_t>( size, UINT32_MAX ) ),
+			.thread = thread,
+			.event = static_cast<uint8_t>( event ),
+			.flags = flags } );
+		++m_recordCount;
+
+		if ( m_pending.size() >= BLOCK_RECORDS && !flush() )
+		{
+			close();
+		}
+	}
+
+	//----------------------------------------------
+	// Private methods
+	//----------------------------------------------
+
+	bool PoolTraceRecorder::flush() noexcept
+	{
+		const size_t written = std::fwrite( m_pending.data(), sizeof( PoolTraceRecord ), m_pending.size(), m_file );
+		const bool complete = written == m_pending.size();
+		m_recordCount -= m_pending.size() - written;
+		m_pending.clear();
+
+		return complete;
+	}
+
+	uint64_t PoolTraceRecorder::close() noexcept
+	{
+		if ( !m_file )
+		{
+			return 0;
+		}
+
+		setPoolFeature( PoolFeature::Trace, false );
+		flush();
+		std::fclose( m_file );
+		m_file = nullptr;
+
+		return m_recordCount;
+	}
+
+	//=====================================================================
+	// Global trace recorder instance
+	//=====================================================================
+
+	PoolTraceRecorder& poolTraceRecorder() noexcept
+	{
+		static PoolTraceRecorder recorder;
+
+		return recorder;
+	}
+} // namespace nfx::string
@@ -0,0 +1,169 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file PoolTraceRecorder.h
+ * @brief Recorder writing pool lease and return events to a binary trace file
+ * @details Internal implementation behind StringBuilderPool::startTrace() / stopTrace().
+ *
+ * Implementation Notes:
+ * - Idle cost: None beyond the shared PoolFeature mask test while no trace is active
+ * - Recording: Events are appended to a buffer under a mutex and written in blocks, so tracing
+ *   serializes pool traffic and is meant for capture sessions, not permanent use
+ * - Format: See PoolTraceFormat.h
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "PoolFeatures.h"
+#include "PoolTraceFormat.h"
+
+namespace nfx::string
+{
+	//=====================================================================
+	// PoolTraceRecorder class
+	//=====================================================================
+
+	/** @brief Process-wide trace recorder */
+	class PoolTraceRecorder final
+	{
+	public:
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+
+		/** @brief Default constructor */
+		PoolTraceRecorder() = default;
+
+		/** @brief Copy constructor */
+		PoolTraceRecorder( const PoolTraceRecorder& ) = delete;
+
+		/** @brief Move constructor */
+		PoolTraceRecorder( PoolTraceRecorder&& ) = delete;
+
+		/** @brief Copy assignment operator */
+		PoolTraceRecorder& operator=( const PoolTraceRecorder& ) = delete;
+
+		/** @brief Move assignment operator */
+		PoolTraceRecorder& operator=( PoolTraceRecorder&& ) = delete;
+
+		//----------------------------------------------
+		// Destruction
+		//----------------------------------------------
+
+		/** @brief Destructor, finishes an active trace */
+		~PoolTraceRecorder();
+
+		//----------------------------------------------
+		// Session control
+		//----------------------------------------------
+
+		/**
+		 * @brief Opens a trace file and starts recording
+		 * @param path Destination file, truncated
+		 * @throws std::logic_error if a trace is already active
+		 * @throws std::runtime_error if the file cannot be opened
+		 */
+		void start( const std::string& path );
+
+		/**
+		 * @brief Stops recording, flushes and closes the trace file
+		 * @return Number of records written, 0 if no trace was active
+		 */
+		uint64_t stop() noexcept;
+
+		/**
+		 * @brief Checks if a trace is being recorded
+		 * @return true between start() and stop()
+		 */
+		bool isActive() const noexcept
+		{
+			return ( poolFeatures() & PoolFeature::Trace ) != 0;
+		}
+
+		//----------------------------------------------
+		// Recording
+		//----------------------------------------------
+
+		/**
+		 * @brief Appends an event
+		 * @param event Event kind
+		 * @param buffer Buffer the event refers to
+		 * @param size Buffer content size for Return events
+		 * @param flags PoolTraceFlag bits
+		 * @details Write errors end the session; the file then holds the records flushed so far.
+		 */
+		void record( PoolTraceEvent event, const void* buffer, size_t size, uint8_t flags = 0 ) noexcept;
+
+	private:
+		//----------------------------------------------
+		// Private methods
+		//----------------------------------------------
+
+		/** @brief Writes buffered records, caller holds m_mutex */
+		bool flush() noexcept;
+
+		/** @brief Closes the file, caller holds m_mutex */
+		uint64_t close() noexcept;
+
+		//----------------------------------------------
+		// Private members
+		//----------------------------------------------
+
+		/** @brief Records buffered before a block write */
+		static constexpr size_t BLOCK_RECORDS = 4096;
+
+		/** @brief Protects all members; the fast-path session flag is PoolFeature::Trace */
+		std::mutex m_mutex;
+
+		/** @brief Open trace file */
+		std::FILE* m_file = nullptr;
+
+		/** @brief Records not yet written */
+		std::vector<PoolTraceRecord> m_pending;
+
+		/** @brief Steady-clock time of session start */
+		uint64_t m_startTime = 0;
+
+		/** @brief Records written or pending in the session */
+		uint64_t m_recordCount = 0;
+	};
+
+	//=====================================================================
+	// Global trace recorder instance
+	//=====================================================================
+
+	/**
+	 * @brief Gets the process-wide trace recorder
+	 * @return Reference to the recorder, shared by all translation units
+	 */
+	PoolTraceRecorder& poolTraceRecorder() noexcept;
+} // namespace nfx::string
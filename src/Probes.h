@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Probes.h
+ * @brief USDT static tracepoints on the pool hot paths
+ * @details Probes are compiled in only when the library is built with NFX_STRINGBUILDERPOOL_ENABLE_USDT
+ *          and sys/sdt.h is available. Each probe is a single nop in the instruction stream until a
+ *          tracer attaches; otherwise the macros expand to nothing and their arguments are not evaluated.
+ *
+ * Provider: nfx_stringbuilderpool
+ *
+ * | Probe                | Arguments                                   |
+ * |----------------------|---------------------------------------------|
+ * | get_thread_local_hit | buffer                                      |
+ * | get_shared_pool_hit  | buffer                                      |
+ * | get_miss             | buffer                                      |
+ * | return_thread_local  | buffer, size                                |
+ * | return_shared_pool   | buffer, size                                |
+ * | discard_pool_full    | buffer, capacity                            |
+ * | discard_oversize     | buffer, capacity                            |
+ * | shrink_oversize      | buffer, capacity                            |
+ * | grow                 | buffer, old capacity, new capacity, copied  |
+ *
+ * Example: bpftrace -e 'usdt:./app:nfx_stringbuilderpool:grow { @[arg2] = count(); }'
+ */
+
+#pragma once
+
+#if defined( NFX_STRINGBUILDERPOOL_USDT )
+
+#	include <sys/sdt.h>
+
+#	define NFX_STRINGBUILDERPOOL_PROBE1( name, arg1 ) \
+		DTRACE_PROBE1( nfx_stringbuilderpool, name, arg1 )
+#	define NFX_STRINGBUILDERPOOL_PROBE2( name, arg1, arg2 ) \
+		DTRACE_PROBE2( nfx_stringbuilderpool, name, arg1, arg2 )
+#	define NFX_STRINGBUILDERPOOL_PROBE4( name, arg1, arg2, arg3, arg4 ) \
+		DTRACE_PROBE4( nfx_stringbuilderpool, name, arg1, arg2, arg3, arg4 )
+
+#else
+
+#	define NFX_STRINGBUILDERPOOL_PROBE1( name, arg1 )
+#	define NFX_STRINGBUILDERPOOL_PROBE2( name, arg1, arg2 )
+#	define NFX_STRINGBUILDERPOOL_PROBE4( name, arg1, arg2, arg3, arg4 )
+
+#endif
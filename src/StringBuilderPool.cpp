@@ -28,73 +28,306 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined( _WIN32 )
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
 
 #include "nfx/string/StringBuilderPool.h"
 #include "DynamicStringBufferPool.h"
+#include "LeaseAttribution.h"
+#include "LeaseTracker.h"
+#include "PoolHistograms.h"
+#include "PoolTraceRecorder.h"
+#include "Probes.h"
+#include "StringInternTable.h"
 
 namespace nfx::string
 {
+	namespace
+	{
+		//=====================================================================
+		// Content hashing primitives
+		//=====================================================================
+
+		/** @brief Initial state of the content hash */
+		constexpr uint64_t HASH_SEED = 0x9E3779B97F4A7C15ull;
+
+		/** @brief Multiplier spreading each block over the hash state */
+		constexpr uint64_t HASH_BLOCK_MULTIPLIER = 0xC2B2AE3D27D4EB4Full;
+
+		/** @brief Multiplier mixing the hash state after each block */
+		constexpr uint64_t HASH_STATE_MULTIPLIER = 0x94D049BB133111EBull;
+
+		/** @brief Bytes folded into the hash state per step */
+		constexpr size_t HASH_BLOCK_SIZE = sizeof( uint64_t );
+
+		/**
+		 * @brief Folds whole 8-byte blocks into a hash state
+		 * @details Blocks are aligned to the start of the content, so the running hash of a buffer
+		 *          covers its first size / 8 blocks and the tail is only read by finishHash().
+		 *          A buffer's content is contiguous, so folding the blocks completed by an append
+		 *          needs no carried-over tail - the hash is independent of how appends split it.
+		 */
+		uint64_t hashBlocks( uint64_t state, const char* data, size_t blockCount ) noexcept
+		{
+			for ( size_t i = 0; i < blockCount; ++i )
+			{
+				uint64_t block;
+				std::memcpy( &block, data + i * HASH_BLOCK_SIZE, HASH_BLOCK_SIZE );
+				state = std::rotl( state ^ ( block * HASH_BLOCK_MULTIPLIER ), 29 ) * HASH_STATE_MULTIPLIER;
+			}
+
+			return state;
+		}
+
+		/** @brief Folds the trailing partial block and the length, then avalanches the state */
+		uint64_t finishHash( uint64_t state, const char* data, size_t size ) noexcept
+		{
+			const size_t tailSize = size % HASH_BLOCK_SIZE;
+			uint64_t tail = 0;
+			if ( tailSize != 0 )
+			{
+				std::memcpy( &tail, data + size - tailSize, tailSize );
+			}
+
+			state = hashBlocks( state, reinterpret_cast<const char*>( &tail ), 1 ) ^ size;
+			state ^= state >> 30;
+			state *= 0xBF58476D1CE4E5B9ull;
+			state ^= state >> 27;
+			state *= HASH_STATE_MULTIPLIER;
+
+			return state ^ ( state >> 31 );
+		}
+
+		/** @brief Hashes content in one pass */
+		uint64_t hashContent( const char* data, size_t size ) noexcept
+		{
+			return finishHash( hashBlocks( HASH_SEED, data, size / HASH_BLOCK_SIZE ), data, size );
+		}
+
+		//=====================================================================
+		// Virtual address space primitives
+		//=====================================================================
+
+		/** @brief Returns the granularity at which reserved address space is committed */
+		size_t pageSize() noexcept
+		{
+#if defined( _WIN32 )
+			static const size_t size = [] {
+				SYSTEM_INFO info;
+				::GetSystemInfo( &info );
+				return static_cast<size_t>( info.dwPageSize );
+			}();
+#else
+			static const size_t size = static_cast<size_t>( ::sysconf( _SC_PAGESIZE ) );
+#endif
+			return size;
+		}
+
+		/** @brief Rounds a byte count up to a whole number of pages */
+		size_t roundUpToPage( size_t bytes ) noexcept
+		{
+			const size_t page = pageSize();
+
+			return ( bytes + page - 1 ) / page * page;
+		}
+
+		/** @brief Reserves an inaccessible address range, returns nullptr on failure */
+		char* reserveAddressRange( size_t size ) noexcept
+		{
+#if defined( _WIN32 )
+			return static_cast<char*>( ::VirtualAlloc( nullptr, size, MEM_RESERVE, PAGE_NOACCESS ) );
+#else
+			void* mapping = ::mmap( nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+
+			return mapping == MAP_FAILED ? nullptr : static_cast<char*>( mapping );
+#endif
+		}
+
+		/** @brief Makes part of a reserved range readable and writable */
+		bool commitAddressRange( char* address, size_t size ) noexcept
+		{
+#if defined( _WIN32 )
+			return ::VirtualAlloc( address, size, MEM_COMMIT, PAGE_READWRITE ) != nullptr;
+#else
+			return ::mprotect( address, size, PROT_READ | PROT_WRITE ) == 0;
+#endif
+		}
+
+		/** @brief Returns committed pages of a reserved range to the system, keeping the range reserved */
+		void decommitAddressRange( char* address, size_t size ) noexcept
+		{
+#if defined( _WIN32 )
+			::VirtualFree( address, size, MEM_DECOMMIT );
+#else
+			static_cast<void>( ::mmap( address, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0 ) );
+#endif
+		}
+
+		/** @brief Releases a whole reserved range */
+		void releaseAddressRange( char* address, size_t size ) noexcept
+		{
+#if defined( _WIN32 )
+			static_cast<void>( size );
+			::VirtualFree( address, 0, MEM_RELEASE );
+#else
+			::munmap( address, size );
+#endif
+		}
+
+		//=====================================================================
+		// Memory resource registry
+		//=====================================================================
+
+		/** @brief Number of registry slots; slot 0 stands for the default allocator */
+		constexpr size_t MEMORY_RESOURCE_SLOTS = std::numeric_limits<uint8_t>::max() + 1;
+
+		/**
+		 * @brief Resources ever installed with StringBuilderPool::setMemoryResource()
+		 * @details Buffers record the slot their heap block came from, so a block is always returned
+		 *          to its own resource. Slots are append-only and never reused.
+		 */
+		struct MemoryResourceRegistry
+		{
+			std::array<std::atomic<std::pmr::memory_resource*>, MEMORY_RESOURCE_SLOTS> resources{};
+			std::atomic<uint8_t> currentSlot{ 0 };
+			size_t slotCount{ 1 };
+			std::mutex mutex;
+		};
+
+		MemoryResourceRegistry& memoryResourceRegistry() noexcept
+		{
+			static MemoryResourceRegistry registry;
+
+			return registry;
+		}
+	} // namespace
+
 	//=====================================================================
 	// DynamicStringBuffer class
 	//=====================================================================
 
+	// Every pooled and thread-cached buffer pays for each byte of the object; new fields must fit
+	// the existing padding or this layout must be revisited deliberately.
+	static_assert( sizeof( void* ) != 8 || sizeof( DynamicStringBuffer ) == 320,
+		"DynamicStringBuffer layout grew" );
+
 	//----------------------------------------------
 	// Construction
 	//----------------------------------------------
 
 	DynamicStringBuffer::DynamicStringBuffer()
-		: m_heapBuffer{ nullptr },
+		: m_data{ m_stackBuffer },
 		  m_size{ 0 },
 		  m_capacity{ STACK_BUFFER_SIZE },
-		  m_onHeap{ false }
+		  m_hash{ HASH_SEED },
+		  m_hashEnabled{ false },
+		  m_resourceSlot{ 0 },
+		  m_attributionSite{ 0 },
+		  m_reservedCapacity{ 0 },
+		  m_leaseStart{ 0 },
+		  m_growthCount{ 0 },
+		  m_growthBytesCopied{ 0 }
 	{
 	}
 
 	DynamicStringBuffer::DynamicStringBuffer( size_t initialCapacity )
-		: m_heapBuffer{ nullptr },
-		  m_size{ 0 }, m_capacity{ STACK_BUFFER_SIZE },
-		  m_onHeap{ false }
+		: m_data{ m_stackBuffer },
+		  m_size{ 0 },
+		  m_capacity{ STACK_BUFFER_SIZE },
+		  m_hash{ HASH_SEED },
+		  m_hashEnabled{ false },
+		  m_resourceSlot{ 0 },
+		  m_attributionSite{ 0 },
+		  m_reservedCapacity{ 0 },
+		  m_leaseStart{ 0 },
+		  m_growthCount{ 0 },
+		  m_growthBytesCopied{ 0 }
 	{
 		if ( initialCapacity > STACK_BUFFER_SIZE )
 		{
-			m_heapBuffer = std::make_unique<char[]>( initialCapacity );
 			m_capacity = initialCapacity;
-			m_onHeap = true;
+			m_data = allocateHeapBuffer( m_capacity, m_resourceSlot );
 		}
 	}
 
 	DynamicStringBuffer::DynamicStringBuffer( const DynamicStringBuffer& other )
-		: m_heapBuffer{ nullptr },
+		: m_data{ m_stackBuffer },
 		  m_size{ other.m_size },
-		  m_capacity{ other.m_capacity },
-		  m_onHeap{ other.m_onHeap }
+		  m_capacity{ STACK_BUFFER_SIZE },
+		  m_hash{ other.m_hash },
+		  m_hashEnabled{ other.m_hashEnabled },
+		  m_resourceSlot{ 0 },
+		  m_attributionSite{ 0 },
+		  m_reservedCapacity{ 0 },
+		  m_leaseStart{ 0 },
+		  m_growthCount{ 0 },
+		  m_growthBytesCopied{ 0 }
 	{
-		if ( m_onHeap )
-		{
-			m_heapBuffer = std::make_unique<char[]>( m_capacity );
-			std::memcpy( m_heapBuffer.get(), other.m_heapBuffer.get(), m_size );
-		}
-		else
+		if ( other.isOnHeap() )
 		{
-			std::memcpy( m_stackBuffer, other.m_stackBuffer, m_size );
+			m_capacity = other.m_capacity;
+			m_data = allocateHeapBuffer( m_capacity, m_resourceSlot );
 		}
+		std::memcpy( m_data, other.m_data, m_size );
 	}
 
 	DynamicStringBuffer::DynamicStringBuffer( DynamicStringBuffer&& other ) noexcept
-		: m_heapBuffer{ std::move( other.m_heapBuffer ) },
+		: m_data{ m_stackBuffer },
 		  m_size{ other.m_size },
 		  m_capacity{ other.m_capacity },
-		  m_onHeap{ other.m_onHeap }
+		  m_hash{ other.m_hash },
+		  m_hashEnabled{ other.m_hashEnabled },
+		  m_resourceSlot{ other.m_resourceSlot },
+		  m_attributionSite{ 0 },
+		  m_reservedCapacity{ other.m_reservedCapacity },
+		  m_leaseStart{ 0 },
+		  m_growthCount{ 0 },
+		  m_growthBytesCopied{ 0 }
 	{
-		if ( !m_onHeap )
+		if ( other.isOnHeap() )
+		{
+			// Steal the heap block
+			m_data = other.m_data;
+		}
+		else
 		{
 			std::memcpy( m_stackBuffer, other.m_stackBuffer, m_size );
 		}
 
+		other.m_data = other.m_stackBuffer;
 		other.m_size = 0;
 		other.m_capacity = STACK_BUFFER_SIZE;
-		other.m_onHeap = false;
+		other.m_hash = HASH_SEED;
+		other.m_reservedCapacity = 0;
+	}
+
+	//----------------------------------------------
+	// Destruction
+	//----------------------------------------------
+
+	DynamicStringBuffer::~DynamicStringBuffer()
+	{
+		releaseHeapBuffer();
 	}
 
 	//----------------------------------------------
@@ -105,29 +338,29 @@ namespace nfx::string
 	{
 		if ( this != &other )
 		{
-			if ( other.m_onHeap )
+			if ( other.isOnHeap() )
 			{
 				// Other uses heap, we need heap too
-				if ( !m_onHeap || m_capacity < other.m_capacity )
+				if ( !isOnHeap() || m_capacity < other.m_capacity )
 				{
-					m_heapBuffer = std::make_unique<char[]>( other.m_capacity );
-					m_capacity = other.m_capacity;
-					m_onHeap = true;
+					size_t newCapacity = other.m_capacity;
+					uint8_t newSlot;
+					char* newBuffer = allocateHeapBuffer( newCapacity, newSlot );
+					releaseHeapBuffer();
+					m_data = newBuffer;
+					m_capacity = newCapacity;
+					m_resourceSlot = newSlot;
 				}
-				std::memcpy( m_heapBuffer.get(), other.m_heapBuffer.get(), other.m_size );
 			}
 			else
 			{
 				// Other uses stack, we can use stack too
-				if ( m_onHeap )
-				{
-					m_heapBuffer.reset();
-					m_capacity = STACK_BUFFER_SIZE;
-					m_onHeap = false;
-				}
-				std::memcpy( m_stackBuffer, other.m_stackBuffer, other.m_size );
+				releaseHeapBuffer();
 			}
+			std::memcpy( m_data, other.m_data, other.m_size );
 			m_size = other.m_size;
+			m_hash = other.m_hash;
+			m_hashEnabled = other.m_hashEnabled;
 		}
 		return *this;
 	}
@@ -136,19 +369,29 @@ namespace nfx::string
 	{
 		if ( this != &other )
 		{
-			m_heapBuffer = std::move( other.m_heapBuffer );
+			releaseHeapBuffer();
+
 			m_size = other.m_size;
 			m_capacity = other.m_capacity;
-			m_onHeap = other.m_onHeap;
+			m_reservedCapacity = other.m_reservedCapacity;
+			m_resourceSlot = other.m_resourceSlot;
+			m_hash = other.m_hash;
+			m_hashEnabled = other.m_hashEnabled;
 
-			if ( !m_onHeap )
+			if ( other.isOnHeap() )
+			{
+				m_data = other.m_data;
+			}
+			else
 			{
 				std::memcpy( m_stackBuffer, other.m_stackBuffer, m_size );
 			}
 
+			other.m_data = other.m_stackBuffer;
 			other.m_size = 0;
 			other.m_capacity = STACK_BUFFER_SIZE;
-			other.m_onHeap = false;
+			other.m_hash = HASH_SEED;
+			other.m_reservedCapacity = 0;
 		}
 		return *this;
 	}
@@ -179,6 +422,7 @@ namespace nfx::string
 	void DynamicStringBuffer::clear() noexcept
 	{
 		m_size = 0;
+		m_hash = HASH_SEED;
 	}
 
 	void DynamicStringBuffer::reserve( size_t newCapacity )
@@ -193,6 +437,99 @@ namespace nfx::string
 	{
 		ensureCapacity( newSize );
 		m_size = newSize;
+
+		if ( m_hashEnabled )
+		{
+			m_hash = hashBlocks( HASH_SEED, m_data, m_size / HASH_BLOCK_SIZE );
+		}
+	}
+
+	void DynamicStringBuffer::reserveAddressSpace( size_t maxCapacity )
+	{
+		if ( maxCapacity < m_size )
+		{
+			throw std::length_error{ "Address space reservation is smaller than the buffer content" };
+		}
+
+		const size_t reservedCapacity = roundUpToPage( maxCapacity );
+		if ( m_reservedCapacity >= reservedCapacity )
+		{
+			return;
+		}
+
+		char* range = reserveAddressRange( reservedCapacity );
+		if ( !range )
+		{
+			throw std::bad_alloc{};
+		}
+
+		const size_t committedCapacity = std::min( roundUpToPage( std::max( m_size, m_capacity ) ), reservedCapacity );
+		if ( !commitAddressRange( range, committedCapacity ) )
+		{
+			releaseAddressRange( range, reservedCapacity );
+			throw std::bad_alloc{};
+		}
+
+		if ( m_size > 0 )
+		{
+			std::memcpy( range, m_data, m_size );
+		}
+		releaseHeapBuffer();
+		m_data = range;
+		m_capacity = committedCapacity;
+		m_reservedCapacity = reservedCapacity;
+	}
+
+	void DynamicStringBuffer::shrinkToFit()
+	{
+		if ( !isOnHeap() )
+		{
+			return;
+		}
+
+		if ( m_reservedCapacity > 0 )
+		{
+			// Keep the range (and data()) but give unused pages back
+			const size_t keptCapacity = std::max( roundUpToPage( m_size ), pageSize() );
+			if ( keptCapacity < m_capacity )
+			{
+				decommitAddressRange( m_data + keptCapacity, m_capacity - keptCapacity );
+				m_capacity = keptCapacity;
+			}
+
+			return;
+		}
+
+		if ( m_size <= STACK_BUFFER_SIZE )
+		{
+			// Revert to the stack buffer
+			std::memcpy( m_stackBuffer, m_data, m_size );
+			releaseHeapBuffer();
+
+			return;
+		}
+
+		size_t newCapacity = m_size;
+		uint8_t newSlot;
+		char* newBuffer = allocateHeapBuffer( newCapacity, newSlot );
+		if ( newCapacity >= m_capacity )
+		{
+			// Block rounding leaves nothing to reclaim
+			deallocateHeapBuffer( newBuffer, newCapacity, newSlot );
+
+			return;
+		}
+
+		std::memcpy( newBuffer, m_data, m_size );
+		releaseHeapBuffer();
+		m_data = newBuffer;
+		m_capacity = newCapacity;
+		m_resourceSlot = newSlot;
+	}
+
+	size_t DynamicStringBuffer::reservedCapacity() const noexcept
+	{
+		return m_reservedCapacity;
 	}
 
 	//----------------------------------------------
@@ -201,22 +538,22 @@ namespace nfx::string
 
 	char* DynamicStringBuffer::data() noexcept
 	{
-		return currentBuffer();
+		return m_data;
 	}
 
 	const char* DynamicStringBuffer::data() const noexcept
 	{
-		return currentBuffer();
+		return m_data;
 	}
 
 	char& DynamicStringBuffer::operator[]( size_t index )
 	{
-		return currentBuffer()[index];
+		return m_data[index];
 	}
 
 	const char& DynamicStringBuffer::operator[]( size_t index ) const
 	{
-		return currentBuffer()[index];
+		return m_data[index];
 	}
 
 	//----------------------------------------------
@@ -229,7 +566,15 @@ namespace nfx::string
 		{
 			const size_t new_size = m_size + str.size();
 			ensureCapacity( new_size );
-			std::memcpy( currentBuffer() + m_size, str.data(), str.size() );
+			std::memcpy( m_data + m_size, str.data(), str.size() );
+
+			if ( m_hashEnabled )
+			{
+				const size_t hashedBlocks = m_size / HASH_BLOCK_SIZE;
+				m_hash = hashBlocks( m_hash, m_data + hashedBlocks * HASH_BLOCK_SIZE,
+					new_size / HASH_BLOCK_SIZE - hashedBlocks );
+			}
+
 			m_size = new_size;
 		}
 	}
@@ -250,8 +595,13 @@ namespace nfx::string
 	void DynamicStringBuffer::push_back( char c )
 	{
 		ensureCapacity( m_size + 1 );
-		currentBuffer()[m_size] = c;
+		m_data[m_size] = c;
 		++m_size;
+
+		if ( m_hashEnabled && m_size % HASH_BLOCK_SIZE == 0 )
+		{
+			m_hash = hashBlocks( m_hash, m_data + m_size - HASH_BLOCK_SIZE, 1 );
+		}
 	}
 
 	//----------------------------------------------
@@ -260,12 +610,52 @@ namespace nfx::string
 
 	std::string DynamicStringBuffer::toString() const
 	{
-		return std::string( currentBuffer(), m_size );
+		return std::string( m_data, m_size );
 	}
 
 	std::string_view DynamicStringBuffer::toStringView() const noexcept
 	{
-		return std::string_view{ currentBuffer(), m_size };
+		return std::string_view{ m_data, m_size };
+	}
+
+	std::string_view DynamicStringBuffer::view( size_t offset, size_t count ) const
+	{
+		if ( offset > m_size )
+		{
+			throw std::out_of_range{ "View offset is past the end of the buffer content" };
+		}
+
+		return std::string_view{ m_data + offset, std::min( count, m_size - offset ) };
+	}
+
+	//----------------------------------------------
+	// Content hashing
+	//----------------------------------------------
+
+	void DynamicStringBuffer::enableIncrementalHash() noexcept
+	{
+		m_hash = hashBlocks( HASH_SEED, m_data, m_size / HASH_BLOCK_SIZE );
+		m_hashEnabled = true;
+	}
+
+	void DynamicStringBuffer::disableIncrementalHash() noexcept
+	{
+		m_hashEnabled = false;
+	}
+
+	bool DynamicStringBuffer::isIncrementalHashEnabled() const noexcept
+	{
+		return m_hashEnabled;
+	}
+
+	uint64_t DynamicStringBuffer::hash() const noexcept
+	{
+		return m_hashEnabled ? finishHash( m_hash, m_data, m_size ) : hashContent( m_data, m_size );
+	}
+
+	uint64_t DynamicStringBuffer::hashOf( std::string_view str ) noexcept
+	{
+		return hashContent( str.data(), str.size() );
 	}
 
 	//----------------------------------------------
@@ -274,22 +664,22 @@ namespace nfx::string
 
 	DynamicStringBuffer::iterator DynamicStringBuffer::begin() noexcept
 	{
-		return currentBuffer();
+		return m_data;
 	}
 
 	DynamicStringBuffer::const_iterator DynamicStringBuffer::begin() const noexcept
 	{
-		return currentBuffer();
+		return m_data;
 	}
 
 	DynamicStringBuffer::iterator DynamicStringBuffer::end() noexcept
 	{
-		return currentBuffer() + m_size;
+		return m_data + m_size;
 	}
 
 	DynamicStringBuffer::const_iterator DynamicStringBuffer::end() const noexcept
 	{
-		return currentBuffer() + m_size;
+		return m_data + m_size;
 	}
 
 	//----------------------------------------------
@@ -303,47 +693,167 @@ namespace nfx::string
 			return;
 		}
 
+		if ( m_reservedCapacity > 0 )
+		{
+			// Grow in place inside the reserved range - no reallocation, no copy
+			[[maybe_unused]] const size_t previousCapacity = m_capacity;
+			commitAddressSpace( needed_capacity );
+			++m_growthCount;
+			NFX_STRINGBUILDERPOOL_PROBE4( grow, this, previousCapacity, m_capacity, 0 );
+
+			return;
+		}
+
 		// Calculate new capacity with growth factor
 		size_t new_capacity = std::max( needed_capacity,
 			static_cast<size_t>( m_capacity * GROWTH_FACTOR ) );
 
-		if ( !m_onHeap && new_capacity <= STACK_BUFFER_SIZE )
+		// Transition from stack to heap, or expand existing heap buffer
+		uint8_t new_slot;
+		char* new_buffer = allocateHeapBuffer( new_capacity, new_slot );
+		if ( m_size > 0 )
 		{
-			return;
+			std::memcpy( new_buffer, m_data, m_size );
 		}
+		NFX_STRINGBUILDERPOOL_PROBE4( grow, this, m_capacity, new_capacity, m_size );
+		releaseHeapBuffer();
+		m_data = new_buffer;
+		m_capacity = new_capacity;
+		m_resourceSlot = new_slot;
+		++m_growthCount;
+		m_growthBytesCopied = static_cast<uint32_t>(
+			std::min<uint64_t>( uint64_t{ m_growthBytesCopied } + m_size, std::numeric_limits<uint32_t>::max() ) );
+	}
+
+	bool DynamicStringBuffer::isOnHeap() const noexcept
+	{
+		return m_data != m_stackBuffer;
+	}
 
-		if ( !m_onHeap )
+	void DynamicStringBuffer::releaseHeapBuffer() noexcept
+	{
+		if ( m_reservedCapacity > 0 )
 		{
-			// Transition from stack to heap
-			m_heapBuffer = std::make_unique<char[]>( new_capacity );
-			if ( m_size > 0 )
-			{
-				std::memcpy( m_heapBuffer.get(), m_stackBuffer, m_size );
-			}
-			m_onHeap = true;
-			m_capacity = new_capacity;
+			releaseAddressRange( m_data, m_reservedCapacity );
+			m_reservedCapacity = 0;
 		}
-		else
+		else if ( isOnHeap() )
 		{
-			// Expand existing heap buffer
-			auto new_buffer = std::make_unique<char[]>( new_capacity );
-			if ( m_size > 0 )
+			deallocateHeapBuffer( m_data, m_capacity, m_resourceSlot );
+		}
+		m_data = m_stackBuffer;
+		m_capacity = STACK_BUFFER_SIZE;
+	}
+
+	void DynamicStringBuffer::commitAddressSpace( size_t neededCapacity )
+	{
+		if ( neededCapacity > m_reservedCapacity )
+		{
+			throw std::length_error{ "Buffer growth exceeds the reserved address space" };
+		}
+
+		// Commit geometrically to keep the number of protection changes logarithmic
+		const size_t newCapacity = std::min( roundUpToPage( std::max( neededCapacity,
+												 static_cast<size_t>( m_capacity * GROWTH_FACTOR ) ) ),
+			m_reservedCapacity );
+
+		if ( !commitAddressRange( m_data + m_capacity, newCapacity - m_capacity ) )
+		{
+			throw std::bad_alloc{};
+		}
+		m_capacity = newCapacity;
+	}
+
+	char* DynamicStringBuffer::allocateHeapBuffer( size_t& capacity, uint8_t& resourceSlot )
+	{
+		auto& registry = memoryResourceRegistry();
+		resourceSlot = registry.currentSlot.load( std::memory_order_acquire );
+		if ( resourceSlot != 0 )
+		{
+			auto* resource = registry.resources[resourceSlot].load( std::memory_order_relaxed );
+
+			return static_cast<char*>( resource->allocate( capacity, HEAP_ALIGNMENT ) );
+		}
+
+#if defined( __linux__ )
+		if ( capacity >= HUGE_PAGE_THRESHOLD )
+		{
+			// Round up to whole huge pages so the mapping can be fully THP-backed
+			capacity = ( capacity + HUGE_PAGE_THRESHOLD - 1 ) & ~( HUGE_PAGE_THRESHOLD - 1 );
+
+			void* mapping = ::mmap( nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+			if ( mapping == MAP_FAILED )
 			{
-				std::memcpy( new_buffer.get(), m_heapBuffer.get(), m_size );
+				throw std::bad_alloc{};
 			}
-			m_heapBuffer = std::move( new_buffer );
-			m_capacity = new_capacity;
+
+#	if defined( MADV_HUGEPAGE )
+			// Advisory only - kernels without THP support simply keep regular pages
+			static_cast<void>( ::madvise( mapping, capacity, MADV_HUGEPAGE ) );
+#	endif
+
+			return static_cast<char*>( mapping );
+		}
+#endif
+
+		return static_cast<char*>( ::operator new[]( capacity, std::align_val_t{ HEAP_ALIGNMENT } ) );
+	}
+
+	void DynamicStringBuffer::deallocateHeapBuffer( char* buffer, size_t capacity, uint8_t resourceSlot ) noexcept
+	{
+		if ( resourceSlot != 0 )
+		{
+			auto* resource = memoryResourceRegistry().resources[resourceSlot].load( std::memory_order_relaxed );
+			resource->deallocate( buffer, capacity, HEAP_ALIGNMENT );
+
+			return;
+		}
+
+#if defined( __linux__ )
+		if ( capacity >= HUGE_PAGE_THRESHOLD )
+		{
+			::munmap( buffer, capacity );
+
+			return;
 		}
+#else
+		static_cast<void>( capacity );
+#endif
+
+		::operator delete[]( buffer, std::align_val_t{ HEAP_ALIGNMENT } );
 	}
 
-	char* DynamicStringBuffer::currentBuffer() noexcept
+	//=====================================================================
+	// PooledString class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Destruction
+	//----------------------------------------------
+
+	PooledString::~PooledString()
 	{
-		return m_onHeap ? m_heapBuffer.get() : m_stackBuffer;
+		dispose();
 	}
 
-	const char* DynamicStringBuffer::currentBuffer() const noexcept
+	//----------------------------------------------
+	// Private implementation methods
+	//----------------------------------------------
+
+	void PooledString::dispose() noexcept
 	{
-		return m_onHeap ? m_heapBuffer.get() : m_stackBuffer;
+		if ( m_buffer )
+		{
+			if ( m_origin && m_origin != DynamicStringBufferPool::threadToken() )
+			{
+				// Taken from an asyncLease and destroyed on another thread
+				dynamicStringBufferPool().returnToSharedPool( std::exchange( m_buffer, nullptr ) );
+			}
+			else
+			{
+				dynamicStringBufferPool().returnToPool( std::exchange( m_buffer, nullptr ) );
+			}
+		}
 	}
 
 	//=====================================================================
@@ -367,12 +877,31 @@ namespace nfx::string
 	{
 		if ( m_valid )
 		{
-			dynamicStringBufferPool().returnToPool( m_buffer );
+			if ( m_origin && m_origin != DynamicStringBufferPool::threadToken() )
+			{
+				// Released after resuming on another thread
+				dynamicStringBufferPool().returnToSharedPool( m_buffer );
+			}
+			else
+			{
+				dynamicStringBufferPool().returnToPool( m_buffer );
+			}
 			m_buffer = nullptr;
 			m_valid = false;
 		}
 	}
 
+	std::string_view StringBuilderLease::intern() const
+	{
+		if ( !m_valid )
+		{
+			throwInvalidOperation();
+		}
+
+		// Reuses the running hash when incremental hashing is enabled
+		return stringInternTable().intern( m_buffer->toStringView(), m_buffer->hash() );
+	}
+
 	void StringBuilderLease::throwInvalidOperation() const
 	{
 		throw std::runtime_error{ "Tried to access StringBuilder after it was returned to pool" };
@@ -382,13 +911,135 @@ namespace nfx::string
 	// StringBuilderPool class
 	//=====================================================================
 
+	//----------------------------------------------
+	// Histogram struct
+	//----------------------------------------------
+
+	size_t StringBuilderPool::Histogram::bucketIndex( uint64_t value ) noexcept
+	{
+		if ( value < SUB_BUCKET_COUNT )
+		{
+			return static_cast<size_t>( value );
+		}
+
+		// Octave e = floor( log2( value ) ) >= 3, split by the 3 bits below the leading one
+		const auto exponent = static_cast<size_t>( std::bit_width( value ) - 1 );
+		const auto subBucket = static_cast<size_t>( ( value >> ( exponent - 3 ) ) & ( SUB_BUCKET_COUNT - 1 ) );
+
+		return ( exponent - 2 ) * SUB_BUCKET_COUNT + subBucket;
+	}
+
+	uint64_t StringBuilderPool::Histogram::bucketLowerBound( size_t index ) noexcept
+	{
+		if ( index < SUB_BUCKET_COUNT )
+		{
+			return index;
+		}
+
+		const size_t exponent = index / SUB_BUCKET_COUNT + 2;
+		const uint64_t subBucket = index % SUB_BUCKET_COUNT;
+
+		return ( SUB_BUCKET_COUNT + subBucket ) << ( exponent - 3 );
+	}
+
+	uint64_t StringBuilderPool::Histogram::bucketUpperBound( size_t index ) noexcept
+	{
+		if ( index < SUB_BUCKET_COUNT )
+		{
+			return index;
+		}
+
+		const size_t exponent = index / SUB_BUCKET_COUNT + 2;
+
+		return bucketLowerBound( index ) + ( ( uint64_t{ 1 } << ( exponent - 3 ) ) - 1 );
+	}
+
+	void StringBuilderPool::Histogram::record( uint64_t value ) noexcept
+	{
+		++buckets[bucketIndex( value )];
+		++count;
+		sum += value;
+		max = std::max( max, value );
+	}
+
+	void StringBuilderPool::Histogram::merge( const Histogram& other ) noexcept
+	{
+		for ( size_t i = 0; i < BUCKET_COUNT; ++i )
+		{
+			buckets[i] += other.buckets[i];
+		}
+		count += other.count;
+		sum += other.sum;
+		max = std::max( max, other.max );
+	}
+
+	uint64_t StringBuilderPool::Histogram::percentile( double percentile ) const noexcept
+	{
+		if ( count == 0 )
+		{
+			return 0;
+		}
+
+		// Rank of the requested value, 1-based
+		const double clamped = std::clamp( percentile, 0.0, 100.0 );
+		const auto rank = std::max<uint64_t>( 1, static_cast<uint64_t>( std::ceil( clamped / 100.0 * static_cast<double>( count ) ) ) );
+
+		uint64_t seen = 0;
+		for ( size_t i = 0; i < BUCKET_COUNT; ++i )
+		{
+			seen += buckets[i];
+			if ( seen >= rank )
+			{
+				return std::min( bucketUpperBound( i ), max );
+			}
+		}
+
+		return max;
+	}
+
+	double StringBuilderPool::Histogram::mean() const noexcept
+	{
+		return count == 0 ? 0.0 : static_cast<double>( sum ) / static_cast<double>( count );
+	}
+
 	//----------------------------------------------
 	// Static factory methods
 	//----------------------------------------------
 
-	StringBuilderLease StringBuilderPool::lease()
+	StringBuilderLease StringBuilderPool::lease( std::source_location location )
+	{
+		StringBuilderLease newLease{ dynamicStringBufferPool().get( location ) };
+
+		return newLease;
+	}
+
+	StringBuilderLease StringBuilderPool::leaseStable( size_t maxCapacity, std::source_location location )
+	{
+		StringBuilderLease stableLease{ dynamicStringBufferPool().get( location ) };
+		stableLease.m_buffer->reserveAddressSpace( maxCapacity );
+
+		return stableLease;
+	}
+
+	StringBuilderLease StringBuilderPool::asyncLease( std::source_location location )
 	{
-		return StringBuilderLease( dynamicStringBufferPool().get() );
+		StringBuilderLease trackedLease{ dynamicStringBufferPool().get( location ), DynamicStringBufferPool::threadToken() };
+
+		return trackedLease;
+	}
+
+	//----------------------------
+	// String interning
+	//----------------------------
+
+	std::string_view StringBuilderPool::intern( std::string_view str )
+	{
+		return stringInternTable().intern( str );
+	}
+
+	size_t StringBuilderPool::internedCount() noexcept
+	{
+		return stringInternTable().size();
 	}
 
 	//----------------------------
@@ -398,17 +1049,164 @@ namespace nfx::string
 	StringBuilderPool::PoolStatistics StringBuilderPool::stats() noexcept
 	{
 		const auto& internalStats = dynamicStringBufferPool().stats();
-		return PoolStatistics{
+		PoolStatistics result{
 			.threadLocalHits = internalStats.threadLocalHits.load(),
 			.dynamicStringBufferPoolHits = internalStats.dynamicStringBufferPoolHits.load(),
 			.newAllocations = internalStats.newAllocations.load(),
 			.totalRequests = internalStats.totalRequests.load(),
-			.hitRate = internalStats.hitRate() };
+			.oversizeShrinks = internalStats.oversizeShrinks.load(),
+			.oversizeDiscards = internalStats.oversizeDiscards.load(),
+			.poolFullDiscards = internalStats.poolFullDiscards.load(),
+			.threadLocalParks = dynamicStringBufferPool().threadLocalParks(),
+			.sharedPoolParks = internalStats.sharedPoolParks.load(),
+			.heapGrowths = internalStats.heapGrowths.load(),
+			.bytesCopiedOnGrowth = internalStats.bytesCopiedOnGrowth.load(),
+			.hitRate = internalStats.hitRate(),
+			.leaseDuration = {},
+			.bufferSize = {},
+			.growthEvents = {} };
+		poolHistograms().snapshot( result.leaseDuration, result.bufferSize, result.growthEvents );
+
+		return result;
 	}
 
 	void StringBuilderPool::resetStats() noexcept
 	{
 		dynamicStringBufferPool().resetStats();
+		poolHistograms().reset();
+	}
+
+	StringBuilderPool::MemoryUsage StringBuilderPool::memoryUsage() noexcept
+	{
+		return dynamicStringBufferPool().memoryUsage();
+	}
+
+	StringBuilderPool::PoolSnapshot StringBuilderPool::snapshot()
+	{
+		return dynamicStringBufferPool().snapshot();
+	}
+
+	void StringBuilderPool::setHistogramsEnabled( bool enabled ) noexcept
+	{
+		poolHistograms().setEnabled( enabled );
+	}
+
+	bool StringBuilderPool::histogramsEnabled() noexcept
+	{
+		return poolHistograms().isEnabled();
+	}
+
+	//----------------------------
+	// Lease attribution
+	//----------------------------
+
+	void StringBuilderPool::setLeaseSampling( uint32_t interval ) noexcept
+	{
+		leaseAttribution().setInterval( interval );
+	}
+
+	uint32_t StringBuilderPool::leaseSampling() noexcept
+	{
+		return leaseAttribution().interval();
+	}
+
+	std::vector<StringBuilderPool::LeaseSiteStatistics> StringBuilderPool::leaseSites()
+	{
+		return leaseAttribution().sites();
+	}
+
+	uint64_t StringBuilderPool::droppedLeaseSamples() noexcept
+	{
+		return leaseAttribution().droppedSamples();
+	}
+
+	void StringBuilderPool::resetLeaseSites() noexcept
+	{
+		leaseAttribution().reset();
+	}
+
+	//----------------------------
+	// Lease tracking
+	//----------------------------
+
+	void StringBuilderPool::setLeaseTracking( bool enabled ) noexcept
+	{
+		leaseTracker().setEnabled( enabled );
+	}
+
+	bool StringBuilderPool::leaseTracking() noexcept
+	{
+		return leaseTracker().isEnabled();
+	}
+
+	size_t StringBuilderPool::outstandingLeaseCount() noexcept
+	{
+		return leaseTracker().outstandingCount();
+	}
+
+	std::vector<StringBuilderPool::OutstandingLease> StringBuilderPool::outstandingLeases( uint64_t minimumAgeNanoseconds )
+	{
+		return leaseTracker().leases( minimumAgeNanoseconds );
+	}
+
+	//----------------------------
+	// Memory resource
+	//----------------------------
+
+	std::pmr::memory_resource* StringBuilderPool::setMemoryResource( std::pmr::memory_resource* resource )
+	{
+		auto& registry = memoryResourceRegistry();
+		std::lock_guard<std::mutex> lock{ registry.mutex };
+
+		size_t slot = 0;
+		if ( resource != nullptr )
+		{
+			slot = 1;
+			while ( slot < registry.slotCount && registry.resources[slot].load( std::memory_order_relaxed ) != resource )
+			{
+				++slot;
+			}
+
+			if ( slot == registry.slotCount )
+			{
+				if ( registry.slotCount == MEMORY_RESOURCE_SLOTS )
+				{
+					throw std::length_error{ "Too many distinct memory resources registered" };
+				}
+				registry.resources[slot].store( resource, std::memory_order_relaxed );
+				++registry.slotCount;
+			}
+		}
+
+		const uint8_t previousSlot = registry.currentSlot.exchange( static_cast<uint8_t>( slot ), std::memory_order_acq_rel );
+
+		return registry.resources[previousSlot].load( std::memory_order_relaxed );
+	}
+
+	std::pmr::memory_resource* StringBuilderPool::memoryResource() noexcept
+	{
+		auto& registry = memoryResourceRegistry();
+
+		return registry.resources[registry.currentSlot.load( std::memory_order_acquire )].load( std::memory_order_relaxed );
+	}
+
+	//----------------------------
+	// Trace recording
+	//----------------------------
+
+	void StringBuilderPool::startTrace( const std::string& path )
+	{
+		poolTraceRecorder().start( path );
+	}
+
+	uint64_t StringBuilderPool::stopTrace() noexcept
+	{
+		return poolTraceRecorder().stop();
+	}
+
+	bool StringBuilderPool::isTracing() noexcept
+	{
+		return poolTraceRecorder().isActive();
 	}
 
 	//----------------------------
@@ -426,4 +1224,14 @@ namespace nfx::string
 	{
 		return dynamicStringBufferPool().size();
 	}
+
+	void StringBuilderPool::setShrinkOversizedBuffers( bool enabled ) noexcept
+	{
+		dynamicStringBufferPool().setShrinkOversizedBuffers( enabled );
+	}
+
+	bool StringBuilderPool::shrinkOversizedBuffers() noexcept
+	{
+		return dynamicStringBufferPool().shrinkOversizedBuffers();
+	}
 } // namespace nfx::string
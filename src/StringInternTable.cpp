@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * @file StringInternTable.cpp
+ * @brief Implementation of the concurrent string intern table
+ */
+
+#include <cstring>
+#include <utility>
+
+#include "nfx/string/StringBuilderPool.h"
+#include "StringInternTable.h"
+
+namespace nfx::string
+{
+	//=====================================================================
+	// StringInternTable class
+	//=====================================================================
+
+	//----------------------------------------------
+	// Interning
+	//----------------------------------------------
+
+	std::string_view StringInternTable::intern( std::string_view str )
+	{
+		if ( str.empty() )
+		{
+			return std::string_view{};
+		}
+
+		return intern( str, DynamicStringBuffer::hashOf( str ) );
+	}
+
+	std::string_view StringInternTable::intern( std::string_view str, uint64_t hash )
+	{
+		if ( str.empty() )
+		{
+			return std::string_view{};
+		}
+
+		// Low bits pick the shard, the remaining bits index its slots
+		Shard& shard = m_shards[hash & ( SHARD_COUNT - 1 )];
+		const uint64_t slotHash = hash / SHARD_COUNT;
+
+		std::lock_guard<std::mutex> lock{ shard.mutex };
+
+		if ( shard.slots.empty() )
+		{
+			shard.slots.resize( INITIAL_SLOT_COUNT, Slot{ 0, nullptr, 0 } );
+		}
+
+		size_t mask = shard.slots.size() - 1;
+		size_t index = slotHash & mask;
+		while ( shard.slots[index].data )
+		{
+			const Slot& slot = shard.slots[index];
+			if ( slot.hash == hash && slot.size == str.size() && std::memcmp( slot.data, str.data(), str.size() ) == 0 )
+			{
+				return std::string_view{ slot.data, slot.size };
+			}
+			index = ( index + 1 ) & mask;
+		}
+
+		// Not present - keep load factor at or below 1/2
+		if ( ( shard.count + 1 ) * 2 > shard.slots.size() )
+		{
+			grow( shard );
+			mask = shard.slots.size() - 1;
+			index = slotHash & mask;
+			while ( shard.slots[index].data )
+			{
+				index = ( index + 1 ) & mask;
+			}
+		}
+
+		const char* stored = store( shard, str );
+		shard.slots[index] = Slot{ hash, stored, str.size() };
+		++shard.count;
+
+		return std::string_view{ stored, str.size() };
+	}
+
+	size_t StringInternTable::size() const noexcept
+	{
+		size_t total = 0;
+		for ( const auto& shard : m_shards )
+		{
+			std::lock_guard<std::mutex> lock{ shard.mutex };
+			total += shard.count;
+		}
+
+		return total;
+	}
+
+	//----------------------------------------------
+	// Private methods
+	//----------------------------------------------
+
+	const char* StringInternTable::store( Shard& shard, std::string_view str )
+	{
+		if ( str.size() > shard.blockRemaining )
+		{
+			// Oversized strings get a dedicated block, the current block keeps its free space
+			if ( str.size() > ARENA_BLOCK_SIZE / 4 )
+			{
+				auto& block = shard.blocks.emplace_back( std::make_unique<char[]>( str.size() ) );
+				std::memcpy( block.get(), str.data(), str.size() );
+
+				return block.get();
+			}
+
+			shard.blockCursor = shard.blocks.emplace_back( std::make_unique<char[]>( ARENA_BLOCK_SIZE ) ).get();
+			shard.blockRemaining = ARENA_BLOCK_SIZE;
+		}
+
+		char* destination = shard.blockCursor;
+		std::memcpy( destination, str.data(), str.size() );
+		shard.blockCursor += str.size();
+		shard.blockRemaining -= str.size();
+
+		return destination;
+	}
+
+	void StringInternTable::grow( Shard& shard )
+	{
+		std::vector<Slot> slots( shard.slots.size() * 2, Slot{ 0, nullptr, 0 } );
+		const size_t mask = slots.size() - 1;
+
+		for ( const auto& slot : shard.slots )
+		{
+			if ( slot.data )
+			{
+				size_t index = ( slot.hash / SHARD_COUNT ) & mask;
+				while ( slots[index].data )
+				{
+					index = ( index + 1 ) & mask;
+				}
+				slots[index] = slot;
+			}
+		}
+
+		shard.slots = std::move( slots );
+	}
+
+	//=====================================================================
+	// Global intern table instance
+	//=====================================================================
+
+	StringInternTable& stringInternTable() noexcept
+	{
+		static StringInternTable table;
+
+		return table;
+	}
+} // namespace nfx::string
@@ -0,0 +1,203 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 nfx
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file StringInternTable.h
+ * @brief Concurrent hash-indexed arena for interned strings
+ * @details Internal implementation behind StringBuilderLease::intern() and StringBuilderPool::intern().
+ *
+ * Implementation Notes:
+ * - Sharding: The hash selects one of SHARD_COUNT independently locked shards
+ * - Index: Open-addressing table per shard storing the full hash, so probing and rehashing never rehash strings
+ * - Arena: Interned characters are copied once into append-only blocks and never move or get freed
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace nfx::string
+{
+	//=====================================================================
+	// StringInternTable class
+	//=====================================================================
+
+	/**
+	 * @brief Thread-safe, append-only table deduplicating strings into stable storage
+	 * @details Each distinct string is stored once; intern() returns a view into the arena that
+	 *          stays valid for the lifetime of the table. Strings are keyed by
+	 *          DynamicStringBuffer::hashOf(), so a builder's running hash is reused as is. A lookup
+	 *          costs at most one hash computation and one probe sequence in a single shard.
+	 */
+	class StringInternTable final
+	{
+	public:
+		//----------------------------------------------
+		// Construction
+		//----------------------------------------------
+
+		/** @brief Default constructor */
+		StringInternTable() = default;
+
+		/** @brief Copy constructor */
+		StringInternTable( const StringInternTable& ) = delete;
+
+		/** @brief Move constructor */
+		StringInternTable( StringInternTable&& ) = delete;
+
+		/** @brief Copy assignment operator */
+		StringInternTable& operator=( const StringInternTable& ) = delete;
+
+		/** @brief Move assignment operator */
+		StringInternTable& operator=( StringInternTable&& ) = delete;
+
+		//----------------------------------------------
+		// Destruction
+		//----------------------------------------------
+
+		/** @brief Destructor */
+		~StringInternTable() = default;
+
+		//----------------------------------------------
+		// Interning
+		//----------------------------------------------
+
+		/**
+		 * @brief Returns the canonical copy of a string, inserting it on first use
+		 * @param str String to intern
+		 * @return View of the interned copy, stable for the lifetime of the table
+		 * @throws std::bad_alloc if arena or index growth fails
+		 */
+		std::string_view intern( std::string_view str );
+
+		/**
+		 * @brief Returns the canonical copy of a string whose hash is already known
+		 * @param str String to intern
+		 * @param hash Value of DynamicStringBuffer::hashOf( str ), e.g. a buffer's hash()
+		 * @return View of the interned copy, stable for the lifetime of the table
+		 * @throws std::bad_alloc if arena or index growth fails
+		 */
+		std::string_view intern( std::string_view str, uint64_t hash );
+
+		/**
+		 * @brief Gets number of distinct interned strings
+		 * @return Total count across all shards
+		 */
+		size_t size() const noexcept;
+
+	private:
+		//----------------------------------------------
+		// Constants
+		//----------------------------------------------
+
+		/** @brief Number of independently locked shards (power of two) */
+		static constexpr size_t SHARD_COUNT = 16;
+
+		/** @brief Initial number of index slots per shard (power of two) */
+		static constexpr size_t INITIAL_SLOT_COUNT = 64;
+
+		/** @brief Size of arena blocks holding interned characters */
+		static constexpr size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+		//----------------------------------------------
+		// Shard structure
+		//----------------------------------------------
+
+		/** @brief Index slot referencing one interned string */
+		struct Slot
+		{
+			/** @brief Full hash of the string */
+			uint64_t hash;
+
+			/** @brief Pointer to the interned characters, nullptr for an empty slot */
+			const char* data;
+
+			/** @brief Length of the interned string */
+			size_t size;
+		};
+
+		/** @brief Independently locked part of the table */
+		struct alignas( 64 ) Shard
+		{
+			/** @brief Mutex protecting this shard */
+			mutable std::mutex mutex;
+
+			/** @brief Open-addressing index with linear probing */
+			std::vector<Slot> slots;
+
+			/** @brief Number of occupied slots */
+			size_t count{ 0 };
+
+			/** @brief Arena blocks owning the interned characters */
+			std::vector<std::unique_ptr<char[]>> blocks;
+
+			/** @brief Write position in the newest arena block */
+			char* blockCursor{ nullptr };
+
+			/** @brief Bytes left in the newest arena block */
+			size_t blockRemaining{ 0 };
+		};
+
+		//----------------------------------------------
+		// Private methods
+		//----------------------------------------------
+
+		/**
+		 * @brief Copies characters into the shard's arena
+		 * @param shard Shard owning the arena (lock held)
+		 * @param str Characters to copy
+		 * @return Pointer to the stable copy
+		 */
+		static const char* store( Shard& shard, std::string_view str );
+
+		/**
+		 * @brief Doubles the shard's index and reinserts all slots by their stored hash
+		 * @param shard Shard to grow (lock held)
+		 */
+		static void grow( Shard& shard );
+
+		//----------------------------------------------
+		// Private member variables
+		//----------------------------------------------
+
+		/** @brief Table shards */
+		std::array<Shard, SHARD_COUNT> m_shards;
+	};
+
+	//----------------------------------------------
+	// Singleton instance access
+	//----------------------------------------------
+
+	/**
+	 * @brief Gets the process-wide StringInternTable instance
+	 * @return Reference to the global intern table, shared by all translation units
+	 * @details Defined out of line so that every translation unit shares one instance
+	 */
+	StringInternTable& stringInternTable() noexcept;
+} // namespace nfx::string
@@ -10,15 +10,29 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <source_location>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <nfx/string/StringBuilderPool.h>
 
+#include "PoolModel.h"
+#include "PoolTraceFormat.h"
+
 namespace nfx::string::test
 {
 	//=====================================================================
@@ -1842,4 +1856,1569 @@ namespace nfx::string::test
 		EXPECT_EQ( buffer2.toString(), "Source buffer modified" );
 		EXPECT_EQ( buffer1.toString(), "Source buffer" ); // Source still unchanged
 	}
+
+	TEST( DynamicStringBufferAdvanced, HeapBufferAlignment )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+
+		// Grow past the stack buffer to force heap storage
+		buffer.append( std::string( 1000, 'A' ) );
+		EXPECT_EQ( reinterpret_cast<std::uintptr_t>( buffer.data() ) % 64, 0 );
+
+		// Growth keeps the alignment guarantee
+		buffer.append( std::string( 5000, 'B' ) );
+		EXPECT_EQ( reinterpret_cast<std::uintptr_t>( buffer.data() ) % 64, 0 );
+		EXPECT_EQ( buffer.size(), 6000 );
+		EXPECT_EQ( buffer[999], 'A' );
+		EXPECT_EQ( buffer[1000], 'B' );
+	}
+
+	TEST( DynamicStringBufferAdvanced, HugePageSizedBuffer )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+		buffer.append( "prefix" );
+
+		// Multi-megabyte reservation takes the huge-page-advised path on Linux
+		const size_t largeCapacity{ 3 * 1024 * 1024 };
+		buffer.reserve( largeCapacity );
+		EXPECT_GE( buffer.capacity(), largeCapacity );
+		EXPECT_EQ( reinterpret_cast<std::uintptr_t>( buffer.data() ) % 64, 0 );
+		EXPECT_EQ( buffer.toStringView(), "prefix" );
+
+		// Fill and copy the large buffer
+		buffer.append( std::string( largeCapacity, 'H' ) );
+		EXPECT_EQ( buffer.size(), largeCapacity + 6 );
+
+		auto lease2{ string::StringBuilderPool::lease() };
+		auto& copy{ lease2.buffer() };
+		copy = buffer;
+		EXPECT_EQ( copy.size(), buffer.size() );
+		EXPECT_EQ( copy.toStringView(), buffer.toStringView() );
+	}
+
+	TEST( DynamicStringBufferAdvanced, AddressSpaceReservation )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+		buffer.append( "header;" );
+		EXPECT_EQ( buffer.reservedCapacity(), 0 );
+
+		// Reserve a large range, content is preserved
+		const size_t reservation{ 64 * 1024 * 1024 };
+		buffer.reserveAddressSpace( reservation );
+		EXPECT_GE( buffer.reservedCapacity(), reservation );
+		EXPECT_EQ( buffer.toStringView(), "header;" );
+
+		// Growth commits pages in place - data pointer never moves
+		const char* stableData{ buffer.data() };
+		const std::string chunk( 4096, 'V' );
+		for ( int i{ 0 }; i < 2048; ++i )
+		{
+			buffer.append( chunk );
+			ASSERT_EQ( buffer.data(), stableData );
+		}
+		EXPECT_EQ( buffer.size(), 7 + 2048 * chunk.size() );
+		EXPECT_LE( buffer.capacity(), buffer.reservedCapacity() );
+		EXPECT_EQ( buffer.toStringView().substr( 0, 8 ), "header;V" );
+		EXPECT_EQ( buffer[buffer.size() - 1], 'V' );
+	}
+
+	TEST( DynamicStringBufferAdvanced, AddressSpaceReservationLimit )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+		buffer.append( std::string( 100, 'x' ) );
+
+		// Reservation smaller than content is rejected
+		EXPECT_THROW( buffer.reserveAddressSpace( 10 ), std::length_error );
+
+		// Growth past the reserved range is rejected and leaves content intact
+		buffer.reserveAddressSpace( 64 * 1024 );
+		const size_t limit{ buffer.reservedCapacity() };
+		EXPECT_THROW( buffer.resize( limit + 1 ), std::length_error );
+		EXPECT_EQ( buffer.size(), 100 );
+		EXPECT_NO_THROW( buffer.resize( limit ) );
+		EXPECT_EQ( buffer.size(), limit );
+
+		// Copies of reserved buffers are regular buffers
+		auto lease2{ string::StringBuilderPool::lease() };
+		auto& copy{ lease2.buffer() };
+		copy = buffer;
+		EXPECT_EQ( copy.reservedCapacity(), 0 );
+		EXPECT_EQ( copy.toStringView(), buffer.toStringView() );
+	}
+
+	TEST( StringBuilderPoolAdvanced, StableLeaseViews )
+	{
+		auto lease{ string::StringBuilderPool::leaseStable() };
+		auto builder{ lease.create() };
+		EXPECT_GE( lease.buffer().reservedCapacity(), string::StringBuilderPool::DEFAULT_STABLE_CAPACITY );
+
+		// Take views of tokens while building
+		std::vector<std::string_view> tokens;
+		std::vector<std::string> expected;
+		for ( int i{ 0 }; i < 20000; ++i )
+		{
+			const size_t start{ builder.length() };
+			builder << "token" << std::to_string( i );
+			tokens.push_back( builder.view( start, builder.length() - start ) );
+			expected.push_back( "token" + std::to_string( i ) );
+			builder << ',';
+		}
+
+		// Earlier views remain valid after the buffer has grown far past its initial capacity
+		EXPECT_GT( builder.length(), 100000 );
+		for ( size_t i{ 0 }; i < tokens.size(); ++i )
+		{
+			ASSERT_EQ( tokens[i], expected[i] );
+		}
+	}
+
+	TEST( DynamicStringBufferAdvanced, RangeView )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+		buffer.append( "Hello, World" );
+
+		EXPECT_EQ( buffer.view( 0, 5 ), "Hello" );
+		EXPECT_EQ( buffer.view( 7, 100 ), "World" ); // Count clamped to content
+		EXPECT_EQ( buffer.view( 12, 1 ), "" );
+		EXPECT_THROW( static_cast<void>( buffer.view( 13, 1 ) ), std::out_of_range );
+	}
+
+	TEST( DynamicStringBufferAdvanced, ShrinkToFit )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+
+		// Heap content that fits the stack buffer moves back inline
+		buffer.append( std::string( 4000, 'S' ) );
+		buffer.resize( 10 );
+		buffer.shrinkToFit();
+		EXPECT_EQ( buffer.capacity(), 256 );
+		EXPECT_EQ( buffer.toStringView(), "SSSSSSSSSS" );
+
+		// Larger content is reallocated down
+		buffer.append( std::string( 10000, 'T' ) );
+		const size_t grownCapacity{ buffer.capacity() };
+		buffer.resize( 1000 );
+		buffer.shrinkToFit();
+		EXPECT_LT( buffer.capacity(), grownCapacity );
+		EXPECT_GE( buffer.capacity(), 1000 );
+		EXPECT_EQ( buffer.size(), 1000 );
+		EXPECT_EQ( buffer[999], 'T' );
+		EXPECT_EQ( reinterpret_cast<std::uintptr_t>( buffer.data() ) % 64, 0 );
+	}
+
+	TEST( DynamicStringBufferAdvanced, ShrinkToFitReservation )
+	{
+		auto lease{ string::StringBuilderPool::leaseStable( 16 * 1024 * 1024 ) };
+		auto& buffer{ lease.buffer() };
+		buffer.append( std::string( 4 * 1024 * 1024, 'R' ) );
+		const char* stableData{ buffer.data() };
+
+		// Decommits the tail but keeps the reservation and data pointer
+		buffer.resize( 100 );
+		buffer.shrinkToFit();
+		EXPECT_LT( buffer.capacity(), 1024 * 1024 );
+		EXPECT_GT( buffer.reservedCapacity(), 0 );
+		EXPECT_EQ( buffer.data(), stableData );
+
+		// Can grow again inside the same range
+		buffer.append( std::string( 1024 * 1024, 'Q' ) );
+		EXPECT_EQ( buffer.data(), stableData );
+		EXPECT_EQ( buffer[99], 'R' );
+		EXPECT_EQ( buffer[100], 'Q' );
+	}
+
+	TEST( StringBuilderPoolAdvanced, OversizedBufferDiscardedByDefault )
+	{
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::resetStats();
+		EXPECT_FALSE( string::StringBuilderPool::shrinkOversizedBuffers() );
+
+		// Grow far beyond the retained capacity: the buffer is deleted on return
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.buffer().append( std::string( 100000, 'O' ) );
+		}
+		EXPECT_EQ( string::StringBuilderPool::size(), 0 );
+
+		// Stable leases are discarded the same way
+		{
+			auto lease{ string::StringBuilderPool::leaseStable() };
+			lease.buffer().append( "stable" );
+		}
+		EXPECT_EQ( string::StringBuilderPool::size(), 0 );
+
+		const auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.totalRequests, 2 );
+		EXPECT_EQ( stats.newAllocations, 2 );
+		EXPECT_EQ( stats.oversizeDiscards, 2 );
+		EXPECT_EQ( stats.oversizeShrinks, 0 );
+	}
+
+	TEST( StringBuilderPoolAdvanced, OversizedBufferReclamation )
+	{
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::resetStats();
+		string::StringBuilderPool::setShrinkOversizedBuffers( true );
+		EXPECT_TRUE( string::StringBuilderPool::shrinkOversizedBuffers() );
+
+		// Grow far beyond the retained capacity
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.buffer().append( std::string( 100000, 'O' ) );
+		}
+
+		// The buffer object is kept, with its heap block released
+		EXPECT_EQ( string::StringBuilderPool::size(), 1 );
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			EXPECT_TRUE( lease.buffer().isEmpty() );
+			EXPECT_LE( lease.buffer().capacity(), 2048 );
+		}
+
+		// Stable leases are reclaimed the same way
+		{
+			auto lease{ string::StringBuilderPool::leaseStable() };
+			lease.buffer().append( "stable" );
+		}
+		EXPECT_EQ( string::StringBuilderPool::size(), 1 );
+
+		const auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.totalRequests, 3 );
+		EXPECT_EQ( stats.newAllocations, 1 );
+		EXPECT_EQ( stats.threadLocalHits, 2 );
+		EXPECT_EQ( stats.oversizeShrinks, 2 );
+
+		string::StringBuilderPool::setShrinkOversizedBuffers( false );
+	}
+
+	//=====================================================================
+	// PooledString
+	//=====================================================================
+
+	TEST( PooledString, TakeFromLease )
+	{
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::resetStats();
+
+		string::PooledString result;
+		EXPECT_TRUE( result.isEmpty() );
+		EXPECT_EQ( result.toStringView(), "" );
+
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "Pooled " << "result " << "without copying";
+			const char* leasedData{ lease.buffer().data() };
+
+			result = lease.take();
+			EXPECT_EQ( result.data(), leasedData ); // Same storage, no copy
+			EXPECT_THROW( static_cast<void>( lease.create() ), std::runtime_error );
+		}
+
+		// Lease ended without returning the buffer - the PooledString owns it
+		EXPECT_EQ( string::StringBuilderPool::size(), 0 );
+		EXPECT_EQ( result, "Pooled result without copying" );
+		EXPECT_EQ( result.size(), 29 );
+		EXPECT_EQ( result.toString(), "Pooled result without copying" );
+		EXPECT_EQ( std::string( result.begin(), result.end() ), "Pooled result without copying" );
+
+		// Move transfers ownership
+		string::PooledString moved{ std::move( result ) };
+		EXPECT_TRUE( result.isEmpty() );
+		EXPECT_EQ( std::string_view{ moved }, "Pooled result without copying" );
+
+		// Destruction returns the buffer to the pool
+		moved = string::PooledString{};
+		EXPECT_EQ( string::StringBuilderPool::size(), 1 );
+
+		// Next lease reuses it
+		auto lease{ string::StringBuilderPool::lease() };
+		EXPECT_TRUE( lease.buffer().isEmpty() );
+		EXPECT_EQ( string::StringBuilderPool::stats().newAllocations, 1 );
+	}
+
+	//=====================================================================
+	// String interning
+	//=====================================================================
+
+	TEST( StringInterning, LeaseInternDeduplicates )
+	{
+		std::string_view first;
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "tag:" << "region=" << "eu-west";
+			first = lease.intern();
+			EXPECT_EQ( lease.toString(), "tag:region=eu-west" ); // Lease unaffected
+		}
+
+		std::string_view second;
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "tag:region=" << "eu-west";
+			second = lease.intern();
+		}
+
+		// A running hash keys the same entry as a freshly computed one
+		std::string_view third;
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.buffer().enableIncrementalHash();
+			lease.create() << "tag:" << "region=eu-west";
+			third = lease.intern();
+		}
+
+		// Same content deduplicates to the same stored copy, outliving the leases
+		EXPECT_EQ( first, "tag:region=eu-west" );
+		EXPECT_EQ( first.data(), second.data() );
+		EXPECT_EQ( first.data(), third.data() );
+		EXPECT_EQ( string::StringBuilderPool::intern( "tag:region=eu-west" ).data(), first.data() );
+		EXPECT_NE( string::StringBuilderPool::intern( "tag:region=us-east" ).data(), first.data() );
+		EXPECT_TRUE( string::StringBuilderPool::intern( "" ).empty() );
+	}
+
+	TEST( StringInterning, ManyStringsRemainStable )
+	{
+		const size_t initialCount{ string::StringBuilderPool::internedCount() };
+
+		// Enough strings to grow every shard's index several times, plus one oversized string
+		std::vector<std::string_view> views;
+		for ( int i{ 0 }; i < 5000; ++i )
+		{
+			views.push_back( string::StringBuilderPool::intern( "metric.name." + std::to_string( i ) ) );
+		}
+		const std::string large( 100000, 'I' );
+		const auto largeView{ string::StringBuilderPool::intern( large ) };
+
+		EXPECT_EQ( string::StringBuilderPool::internedCount(), initialCount + 5001 );
+		for ( int i{ 0 }; i < 5000; ++i )
+		{
+			const std::string expected{ "metric.name." + std::to_string( i ) };
+			ASSERT_EQ( views[i], expected );
+			ASSERT_EQ( string::StringBuilderPool::intern( expected ).data(), views[i].data() );
+		}
+		EXPECT_EQ( largeView, large );
+		EXPECT_EQ( string::StringBuilderPool::internedCount(), initialCount + 5001 );
+	}
+
+	TEST( StringInterning, ConcurrentInterning )
+	{
+		const int threadCount{ 8 };
+		std::vector<std::vector<const char*>> results( threadCount );
+		std::vector<std::thread> threads;
+
+		// All threads intern the same strings concurrently
+		for ( int t{ 0 }; t < threadCount; ++t )
+		{
+			threads.emplace_back( [&results, t]() {
+				for ( int i{ 0 }; i < 1000; ++i )
+				{
+					auto lease{ string::StringBuilderPool::lease() };
+					lease.create() << "shared." << std::to_string( i );
+					results[t].push_back( lease.intern().data() );
+				}
+			} );
+		}
+		for ( auto& thread : threads )
+		{
+			thread.join();
+		}
+
+		// Every thread observed the same canonical copy
+		for ( int t{ 1 }; t < threadCount; ++t )
+		{
+			EXPECT_EQ( results[t], results[0] );
+		}
+	}
+
+	TEST( DynamicStringBufferAdvanced, IncrementalHash )
+	{
+		auto lease{ string::StringBuilderPool::lease() };
+		auto& buffer{ lease.buffer() };
+		auto builder{ lease.create() };
+
+		// Disabled by default, hash() computes on demand
+		EXPECT_FALSE( buffer.isIncrementalHashEnabled() );
+		builder << "shard:";
+		EXPECT_EQ( buffer.hash(), string::DynamicStringBuffer::hashOf( "shard:" ) );
+
+		// Enabled mid-build, covers existing and appended content
+		buffer.enableIncrementalHash();
+		EXPECT_TRUE( buffer.isIncrementalHashEnabled() );
+		builder << "user" << '-' << std::string( "42" );
+		EXPECT_EQ( buffer.hash(), string::DynamicStringBuffer::hashOf( "shard:user-42" ) );
+
+		// Distinct content hashes differently
+		EXPECT_NE( buffer.hash(), string::DynamicStringBuffer::hashOf( "shard:user-43" ) );
+
+		// Independent of how content was split across appends
+		const std::string content{ "tenant:eu-west/user:1234567/session:abcdef" };
+		const uint64_t oneShot{ string::DynamicStringBuffer::hashOf( content ) };
+		for ( const size_t step : { size_t{ 1 }, size_t{ 3 }, size_t{ 7 }, size_t{ 8 }, size_t{ 13 }, content.size() } )
+		{
+			auto splitLease{ string::StringBuilderPool::lease() };
+			auto& split{ splitLease.buffer() };
+			split.enableIncrementalHash();
+			for ( size_t offset = 0; offset < content.size(); offset += step )
+			{
+				split.append( std::string_view{ content }.substr( offset, step ) );
+			}
+			EXPECT_EQ( split.hash(), oneShot ) << "step " << step;
+		}
+
+		auto pushedLease{ string::StringBuilderPool::lease() };
+		auto& pushed{ pushedLease.buffer() };
+		pushed.enableIncrementalHash();
+		for ( const char c : content )
+		{
+			pushed.push_back( c );
+		}
+		EXPECT_EQ( pushed.hash(), oneShot );
+
+		// Growth onto the heap keeps the running hash
+		const std::string large( 1000, 'h' );
+		builder << large;
+		EXPECT_EQ( buffer.hash(), string::DynamicStringBuffer::hashOf( "shard:user-42" + large ) );
+
+		// resize() and clear() keep the hash consistent
+		buffer.resize( 6 );
+		EXPECT_EQ( buffer.hash(), string::DynamicStringBuffer::hashOf( "shard:" ) );
+		buffer.clear();
+		EXPECT_EQ( buffer.hash(), string::DynamicStringBuffer::hashOf( "" ) );
+		builder << "again";
+		EXPECT_EQ( buffer.hash(), string::DynamicStringBuffer::hashOf( "again" ) );
+	}
+
+	TEST( DynamicStringBufferAdvanced, IncrementalHashResetOnReturn )
+	{
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.buffer().enableIncrementalHash();
+		}
+
+		auto lease{ string::StringBuilderPool::lease() };
+		EXPECT_FALSE( lease.buffer().isIncrementalHashEnabled() );
+	}
+
+	//----------------------------------------------
+	// Heterogeneous lookup
+	//----------------------------------------------
+
+	TEST( HeterogeneousLookup, LeaseKeyFindsStringKeys )
+	{
+		std::unordered_map<std::string, int, string::StringKeyHash, string::StringKeyEqual> map{
+			{ "user:42", 1 }, { "user:43", 2 } };
+
+		auto lease{ string::StringBuilderPool::lease() };
+		auto builder{ lease.create() };
+		builder << "user:" << "42";
+
+		// Lookup through the precomputed key hash
+		auto it{ map.find( lease.key() ) };
+		ASSERT_NE( it, map.end() );
+		EXPECT_EQ( it->second, 1 );
+
+		// Same result with the running hash enabled mid-build
+		builder.resize( 5 );
+		lease.buffer().enableIncrementalHash();
+		builder << '4' << '3';
+		EXPECT_EQ( lease.key().hash(), string::DynamicStringBuffer::hashOf( "user:43" ) );
+		it = map.find( lease.key() );
+		ASSERT_NE( it, map.end() );
+		EXPECT_EQ( it->second, 2 );
+
+		// Plain views and misses
+		EXPECT_TRUE( map.contains( std::string_view{ "user:42" } ) );
+		builder << '0';
+		EXPECT_EQ( map.find( lease.key() ), map.end() );
+	}
+
+	//----------------------------------------------
+	// Coroutine leases
+	//----------------------------------------------
+
+	/** @brief Minimal thread-pool executor resuming coroutines on its worker threads */
+	class ThreadPoolExecutor final
+	{
+	public:
+		explicit ThreadPoolExecutor( size_t threadCount )
+		{
+			for ( size_t i = 0; i < threadCount; ++i )
+			{
+				m_workers.emplace_back( [this]() { run(); } );
+			}
+		}
+
+		~ThreadPoolExecutor()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				m_stopping = true;
+			}
+			m_ready.notify_all();
+
+			for ( auto& worker : m_workers )
+			{
+				worker.join();
+			}
+		}
+
+		/** @brief Awaitable that resumes the awaiting coroutine on a worker thread */
+		auto schedule()
+		{
+			struct ScheduleAwaiter
+			{
+				ThreadPoolExecutor& executor;
+
+				bool await_ready() const noexcept { return false; }
+				void await_suspend( std::coroutine_handle<> handle ) { executor.post( handle ); }
+				void await_resume() const noexcept {}
+			};
+
+			return ScheduleAwaiter{ *this };
+		}
+
+	private:
+		void post( std::coroutine_handle<> handle )
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				m_queue.push_back( handle );
+			}
+			m_ready.notify_one();
+		}
+
+		void run()
+		{
+			while ( true )
+			{
+				std::coroutine_handle<> handle;
+				{
+					std::unique_lock<std::mutex> lock{ m_mutex };
+					m_ready.wait( lock, [this]() { return m_stopping || !m_queue.empty(); } );
+					if ( m_queue.empty() )
+					{
+						return;
+					}
+					handle = m_queue.front();
+					m_queue.pop_front();
+				}
+				handle.resume();
+			}
+		}
+
+		std::vector<std::thread> m_workers;
+		std::deque<std::coroutine_handle<>> m_queue;
+		std::mutex m_mutex;
+		std::condition_variable m_ready;
+		bool m_stopping{ false };
+	};
+
+	/** @brief Eagerly started coroutine whose frame is destroyed on completion */
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object() noexcept { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { std::terminate(); }
+		};
+	};
+
+	/** @brief Countdown signalled by coroutines as they complete */
+	struct CompletionLatch
+	{
+		explicit CompletionLatch( int count )
+			: remaining{ count }
+		{
+		}
+
+		void countDown()
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			if ( --remaining == 0 )
+			{
+				done.notify_all();
+			}
+		}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			done.wait( lock, [this]() { return remaining == 0; } );
+		}
+
+		int remaining;
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+
+	DetachedTask buildAcrossResume(
+		ThreadPoolExecutor& executor, CompletionLatch& latch, std::string& result,
+		const string::DynamicStringBuffer*& leasedBuffer, std::thread::id& releasingThread )
+	{
+		auto lease{ string::StringBuilderPool::asyncLease() };
+		leasedBuffer = &lease.buffer();
+		lease.create() << "request:";
+
+		co_await executor.schedule();
+
+		lease.create() << "handled";
+		result = lease.toString();
+		releasingThread = std::this_thread::get_id();
+
+		// Release on the worker thread before signalling completion
+		{
+			auto released{ std::move( lease ) };
+		}
+		latch.countDown();
+	}
+
+	TEST( CoroutineLease, ReleaseOnResumingThreadReturnsToSharedPool )
+	{
+		string::StringBuilderPool::clear();
+
+		std::string result;
+		const string::DynamicStringBuffer* leasedBuffer{ nullptr };
+		std::thread::id releasingThread;
+
+		{
+			ThreadPoolExecutor executor{ 1 };
+			CompletionLatch latch{ 1 };
+			buildAcrossResume( executor, latch, result, leasedBuffer, releasingThread );
+			latch.wait();
+		}
+
+		EXPECT_EQ( result, "request:handled" );
+		EXPECT_NE( releasingThread, std::this_thread::get_id() );
+
+		// The buffer went to the shared pool rather than the worker's thread-local cache,
+		// so the leasing thread gets it back
+		EXPECT_EQ( string::StringBuilderPool::size(), 1 );
+		string::StringBuilderPool::resetStats();
+		auto lease{ string::StringBuilderPool::lease() };
+		EXPECT_EQ( &lease.buffer(), leasedBuffer );
+		EXPECT_EQ( string::StringBuilderPool::stats().dynamicStringBufferPoolHits, 1 );
+	}
+
+	TEST( CoroutineLease, ReleaseOnLeasingThreadUsesThreadLocalCache )
+	{
+		string::StringBuilderPool::clear();
+
+		const string::DynamicStringBuffer* leasedBuffer{ nullptr };
+		{
+			auto lease{ string::StringBuilderPool::asyncLease() };
+			leasedBuffer = &lease.buffer();
+		}
+
+		string::StringBuilderPool::resetStats();
+		auto lease{ string::StringBuilderPool::lease() };
+		EXPECT_EQ( &lease.buffer(), leasedBuffer );
+		EXPECT_EQ( string::StringBuilderPool::stats().threadLocalHits, 1 );
+	}
+
+	TEST( CoroutineLease, TakenStringReleasedElsewhereReturnsToSharedPool )
+	{
+		string::StringBuilderPool::clear();
+
+		auto lease{ string::StringBuilderPool::asyncLease() };
+		const string::DynamicStringBuffer* leasedBuffer{ &lease.buffer() };
+		lease.create() << "response";
+		auto taken{ lease.take() };
+		string::StringBuilderPool::resetStats();
+
+		std::thread worker{ [&taken]() {
+			EXPECT_EQ( taken, "response" );
+			auto released{ std::move( taken ) };
+		} };
+		worker.join();
+
+		// Routed like the lease itself, not parked in the worker's cache
+		const auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.sharedPoolParks, 1 );
+		EXPECT_EQ( stats.threadLocalParks, 0 );
+
+		auto next{ string::StringBuilderPool::lease() };
+		EXPECT_EQ( &next.buffer(), leasedBuffer );
+	}
+
+	TEST( CoroutineLease, ManyCoroutinesAcrossWorkers )
+	{
+		constexpr int coroutineCount{ 200 };
+
+		std::vector<std::string> results( coroutineCount );
+		std::vector<const string::DynamicStringBuffer*> buffers( coroutineCount );
+		std::vector<std::thread::id> threads( coroutineCount );
+
+		{
+			ThreadPoolExecutor executor{ 4 };
+			CompletionLatch latch{ coroutineCount };
+			for ( int i = 0; i < coroutineCount; ++i )
+			{
+				buildAcrossResume( executor, latch, results[i], buffers[i], threads[i] );
+			}
+			latch.wait();
+		}
+
+		for ( const auto& result : results )
+		{
+			EXPECT_EQ( result, "request:handled" );
+		}
+	}
+
+	//----------------------------------------------
+	// Histograms
+	//----------------------------------------------
+
+	TEST( PoolHistograms, BucketLayout )
+	{
+		using Histogram = string::StringBuilderPool::Histogram;
+
+		// Exact buckets below 8, then 8 sub-buckets per power of two
+		EXPECT_EQ( Histogram::bucketIndex( 0 ), 0 );
+		EXPECT_EQ( Histogram::bucketIndex( 7 ), 7 );
+		EXPECT_EQ( Histogram::bucketIndex( 8 ), 8 );
+		EXPECT_EQ( Histogram::bucketIndex( 15 ), 15 );
+		EXPECT_EQ( Histogram::bucketIndex( 16 ), 16 );
+		EXPECT_EQ( Histogram::bucketIndex( 17 ), 16 );
+		EXPECT_EQ( Histogram::bucketIndex( UINT64_MAX ), Histogram::BUCKET_COUNT - 1 );
+
+		// Every bucket's bounds map back to it and buckets tile the range
+		for ( size_t i = 0; i < Histogram::BUCKET_COUNT; ++i )
+		{
+			EXPECT_EQ( Histogram::bucketIndex( Histogram::bucketLowerBound( i ) ), i );
+			EXPECT_EQ( Histogram::bucketIndex( Histogram::bucketUpperBound( i ) ), i );
+			if ( i + 1 < Histogram::BUCKET_COUNT )
+			{
+				EXPECT_EQ( Histogram::bucketUpperBound( i ) + 1, Histogram::bucketLowerBound( i + 1 ) );
+			}
+		}
+		EXPECT_EQ( Histogram::bucketUpperBound( Histogram::BUCKET_COUNT - 1 ), UINT64_MAX );
+	}
+
+	TEST( PoolHistograms, RecordAndPercentiles )
+	{
+		string::StringBuilderPool::Histogram histogram{};
+		EXPECT_EQ( histogram.percentile( 50.0 ), 0 );
+
+		for ( uint64_t value = 1; value <= 1000; ++value )
+		{
+			histogram.record( value );
+		}
+
+		EXPECT_EQ( histogram.count, 1000 );
+		EXPECT_EQ( histogram.sum, 500500 );
+		EXPECT_EQ( histogram.max, 1000 );
+		EXPECT_DOUBLE_EQ( histogram.mean(), 500.5 );
+
+		// Within the 12.5% bucket resolution, never above max
+		EXPECT_NEAR( static_cast<double>( histogram.percentile( 50.0 ) ), 500.0, 500.0 * 0.125 );
+		EXPECT_NEAR( static_cast<double>( histogram.percentile( 99.0 ) ), 990.0, 990.0 * 0.125 );
+		EXPECT_EQ( histogram.percentile( 100.0 ), 1000 );
+
+		string::StringBuilderPool::Histogram other{};
+		other.record( 5000 );
+		histogram.merge( other );
+		EXPECT_EQ( histogram.count, 1001 );
+		EXPECT_EQ( histogram.max, 5000 );
+	}
+
+	TEST( PoolHistograms, LeaseRecording )
+	{
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::setHistogramsEnabled( true );
+		EXPECT_TRUE( string::StringBuilderPool::histogramsEnabled() );
+
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "short";
+		}
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 5000, 'x' ); // Grows past the stack buffer
+		}
+
+		// Leases released on other threads merge in when those threads exit
+		std::thread worker{ []() {
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "worker";
+		} };
+		worker.join();
+
+		string::StringBuilderPool::setHistogramsEnabled( false );
+		{
+			auto lease{ string::StringBuilderPool::lease() }; // Not recorded
+		}
+
+		const auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.leaseDuration.count, 3 );
+		EXPECT_EQ( stats.bufferSize.count, 3 );
+		EXPECT_EQ( stats.bufferSize.max, 5000 );
+		EXPECT_EQ( stats.bufferSize.sum, 5000 + 5 + 6 );
+		EXPECT_EQ( stats.growthEvents.count, 3 );
+		EXPECT_GE( stats.growthEvents.max, 1 );
+
+		string::StringBuilderPool::resetStats();
+		EXPECT_EQ( string::StringBuilderPool::stats().leaseDuration.count, 0 );
+	}
+
+	TEST( StringBuilderPoolManagement, ReturnAndGrowthCounters )
+	{
+		string::StringBuilderPool::clear();
+
+		// Growth from the stack buffer copies the existing content
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			auto builder{ lease.create() };
+			builder << std::string( 200, 'a' );
+			builder << std::string( 200, 'b' );
+		}
+		auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.heapGrowths, 1 );
+		EXPECT_EQ( stats.bytesCopiedOnGrowth, 200 );
+		EXPECT_EQ( stats.threadLocalParks, 1 );
+
+		// Growths are counted when the lease returns, and only for pooled buffers
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 1000, 'd' );
+			EXPECT_EQ( string::StringBuilderPool::stats().heapGrowths, 1 );
+
+			string::DynamicStringBuffer standalone{ lease.buffer() };
+			standalone.append( std::string( 5000, 'e' ) );
+		}
+		EXPECT_EQ( string::StringBuilderPool::stats().heapGrowths, 2 );
+		EXPECT_EQ( string::StringBuilderPool::stats().threadLocalParks, 2 );
+
+		// Oversized buffer is deleted on return, or shrunk once shrinking is enabled
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 10000, 'c' );
+		}
+		stats = string::StringBuilderPool::stats();
+		EXPECT_EQ( stats.oversizeShrinks, 0 );
+		EXPECT_EQ( stats.oversizeDiscards, 1 );
+
+		string::StringBuilderPool::setShrinkOversizedBuffers( true );
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 10000, 'c' );
+		}
+		string::StringBuilderPool::setShrinkOversizedBuffers( false );
+		stats = string::StringBuilderPool::stats();
+		EXPECT_EQ( stats.oversizeShrinks, 1 );
+		EXPECT_EQ( stats.oversizeDiscards, 1 );
+
+		// Second concurrent lease returns to the shared pool
+		{
+			auto first{ string::StringBuilderPool::lease() };
+			auto second{ string::StringBuilderPool::lease() };
+		}
+		stats = string::StringBuilderPool::stats();
+		EXPECT_EQ( stats.threadLocalParks, 4 );
+		EXPECT_EQ( stats.sharedPoolParks, 1 );
+		EXPECT_EQ( stats.poolFullDiscards, 0 );
+
+		// More simultaneous leases than the shared pool holds (24) discard the excess
+		{
+			std::vector<string::StringBuilderLease> leases;
+			for ( int i = 0; i < 30; ++i )
+			{
+				leases.push_back( string::StringBuilderPool::lease() );
+			}
+		}
+		stats = string::StringBuilderPool::stats();
+		EXPECT_GT( stats.poolFullDiscards, 0 );
+		EXPECT_EQ( stats.threadLocalParks + stats.sharedPoolParks + stats.poolFullDiscards, 35 );
+
+		string::StringBuilderPool::resetStats();
+		EXPECT_EQ( string::StringBuilderPool::stats().heapGrowths, 0 );
+	}
+
+	TEST( StringBuilderPoolManagement, ThreadLocalParksAcrossThreads )
+	{
+		string::StringBuilderPool::resetStats();
+
+		std::thread worker{ []() {
+			for ( int i = 0; i < 3; ++i )
+			{
+				auto lease{ string::StringBuilderPool::lease() };
+			}
+
+			// Counted per thread, summed while the thread is alive
+			EXPECT_EQ( string::StringBuilderPool::stats().threadLocalParks, 3 );
+		} };
+		worker.join();
+
+		// Kept after the thread exits
+		EXPECT_EQ( string::StringBuilderPool::stats().threadLocalParks, 3 );
+
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+		}
+		EXPECT_EQ( string::StringBuilderPool::stats().threadLocalParks, 4 );
+
+		string::StringBuilderPool::resetStats();
+		EXPECT_EQ( string::StringBuilderPool::stats().threadLocalParks, 0 );
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+		}
+		EXPECT_EQ( string::StringBuilderPool::stats().threadLocalParks, 1 );
+	}
+
+	//----------------------------------------------
+	// Metrics export
+	//----------------------------------------------
+
+	TEST( OpenMetricsExport, CurrentPool )
+	{
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::setHistogramsEnabled( true );
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 300, 'x' );
+		}
+		string::StringBuilderPool::setHistogramsEnabled( false );
+
+		auto lease{ string::StringBuilderPool::lease() };
+		auto builder{ lease.create() };
+		string::StringBuilderPool::exportOpenMetrics( builder, "api" );
+		const std::string text{ lease.toString() };
+
+		EXPECT_NE( text.find( "# TYPE nfx_stringbuilderpool_requests counter\n" ), std::string::npos );
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_requests_total{pool=\"api\"} 2\n" ), std::string::npos );
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_growths_total{pool=\"api\"} 1\n" ), std::string::npos );
+		EXPECT_NE( text.find( "# UNIT nfx_stringbuilderpool_lease_duration_seconds seconds\n" ), std::string::npos );
+
+		// 300 bytes falls in the (255, 511] bucket
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_buffer_size_bytes_bucket{pool=\"api\",le=\"255\"} 0\n" ), std::string::npos );
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_buffer_size_bytes_bucket{pool=\"api\",le=\"511\"} 1\n" ), std::string::npos );
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_buffer_size_bytes_bucket{pool=\"api\",le=\"+Inf\"} 1\n" ), std::string::npos );
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_buffer_size_bytes_sum{pool=\"api\"} 300\n" ), std::string::npos );
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_lease_duration_seconds_count{pool=\"api\"} 1\n" ), std::string::npos );
+
+		// Terminated exactly once, at the end
+		EXPECT_TRUE( text.ends_with( "# EOF\n" ) );
+		EXPECT_EQ( text.find( "# EOF" ), text.size() - 6 );
+	}
+
+	TEST( OpenMetricsExport, NamedPools )
+	{
+		string::StringBuilderPool::PoolStatistics first{};
+		first.totalRequests = 10;
+		string::StringBuilderPool::PoolStatistics second{};
+		second.totalRequests = 20;
+
+		const std::array<string::StringBuilderPool::MetricsSource, 2> sources{ {
+			{ "front", first },
+			{ "back\"end", second } } };
+
+		auto lease{ string::StringBuilderPool::lease() };
+		auto builder{ lease.create() };
+		string::StringBuilderPool::exportOpenMetrics( builder, sources );
+		const std::string text{ lease.toString() };
+
+		// Samples of one family are contiguous, one per pool, with escaped label values
+		EXPECT_NE( text.find( "nfx_stringbuilderpool_requests_total{pool=\"front\"} 10\n"
+							  "nfx_stringbuilderpool_requests_total{pool=\"back\\\"end\"} 20\n" ),
+			std::string::npos );
+
+		// Family declared once
+		const std::string header{ "# TYPE nfx_stringbuilderpool_requests counter" };
+		EXPECT_EQ( text.find( header ), text.rfind( header ) );
+	}
+
+	//----------------------------------------------
+	// Lease attribution
+	//----------------------------------------------
+
+	TEST( LeaseAttribution, SampledCallSites )
+	{
+		EXPECT_EQ( string::StringBuilderPool::leaseSampling(), 0 );
+
+		// Disabled by default - nothing recorded
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+		}
+		string::StringBuilderPool::resetLeaseSites();
+
+		string::StringBuilderPool::setLeaseSampling( 1 );
+		const auto largeLine{ std::source_location::current().line() + 3 };
+		for ( int i = 0; i < 4; ++i )
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 1000, 'L' );
+		}
+		for ( int i = 0; i < 2; ++i )
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "small";
+			auto result{ lease.take() }; // Recorded when the PooledString returns the buffer
+		}
+		string::StringBuilderPool::setLeaseSampling( 0 );
+
+		const auto sites{ string::StringBuilderPool::leaseSites() };
+		ASSERT_GE( sites.size(), 2 );
+
+		// Largest total first
+		EXPECT_EQ( sites[0].line, largeLine );
+		EXPECT_NE( sites[0].file.find( "TESTS_StringBuilderPool.cpp" ), std::string_view::npos );
+		EXPECT_NE( sites[0].function.find( "SampledCallSites" ), std::string_view::npos );
+		EXPECT_EQ( sites[0].sampledLeases, 4 );
+		EXPECT_EQ( sites[0].totalBytes, 4000 );
+		EXPECT_EQ( sites[0].maxBytes, 1000 );
+		EXPECT_GE( sites[0].totalNanoseconds, sites[0].maxNanoseconds );
+
+		EXPECT_EQ( sites[1].line, largeLine + 5 );
+		EXPECT_EQ( sites[1].sampledLeases, 2 );
+		EXPECT_EQ( sites[1].totalBytes, 10 );
+
+		// Every sample found a slot
+		EXPECT_EQ( string::StringBuilderPool::droppedLeaseSamples(), 0 );
+
+		string::StringBuilderPool::resetLeaseSites();
+		for ( const auto& site : string::StringBuilderPool::leaseSites() )
+		{
+			EXPECT_EQ( site.sampledLeases, 0 );
+		}
+	}
+
+	TEST( LeaseAttribution, SamplingInterval )
+	{
+		string::StringBuilderPool::resetLeaseSites();
+		string::StringBuilderPool::setLeaseSampling( 4 );
+		const auto line{ std::source_location::current().line() + 3 };
+		for ( int i = 0; i < 40; ++i )
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+		}
+		string::StringBuilderPool::setLeaseSampling( 0 );
+
+		uint64_t sampled{ 0 };
+		for ( const auto& site : string::StringBuilderPool::leaseSites() )
+		{
+			if ( site.line == line )
+			{
+				sampled += site.sampledLeases;
+			}
+		}
+		EXPECT_EQ( sampled, 10 );
+	}
+
+	//----------------------------------------------
+	// Trace recording
+	//----------------------------------------------
+
+	TEST( PoolTrace, RecordsLeaseAndReturnEvents )
+	{
+		const std::string path{ ::testing::TempDir() + "nfx_pool_trace.bin" };
+
+		EXPECT_FALSE( string::StringBuilderPool::isTracing() );
+		EXPECT_EQ( string::StringBuilderPool::stopTrace(), 0 );
+
+		string::StringBuilderPool::startTrace( path );
+		EXPECT_TRUE( string::StringBuilderPool::isTracing() );
+		EXPECT_THROW( string::StringBuilderPool::startTrace( path ), std::logic_error );
+		{
+			auto outer{ string::StringBuilderPool::lease() };
+			outer.create() << "outer";
+			{
+				auto inner{ string::StringBuilderPool::lease() };
+				inner.create() << std::string( 300, 'i' );
+			}
+		}
+		{
+			auto async{ string::StringBuilderPool::asyncLease() };
+			std::thread{ [&async]() { auto released{ std::move( async ) }; } }.join();
+		}
+		EXPECT_EQ( string::StringBuilderPool::stopTrace(), 6 );
+		EXPECT_FALSE( string::StringBuilderPool::isTracing() );
+
+		// Not recorded once stopped
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+		}
+
+		std::FILE* file{ std::fopen( path.c_str(), "rb" ) };
+		ASSERT_NE( file, nullptr );
+		string::PoolTraceHeader header{};
+		std::array<string::PoolTraceRecord, 7> records{};
+		ASSERT_EQ( std::fread( &header, sizeof( header ), 1, file ), 1 );
+		const size_t count{ std::fread( records.data(), sizeof( string::PoolTraceRecord ), records.size(), file ) };
+		std::fclose( file );
+		std::remove( path.c_str() );
+
+		EXPECT_EQ( header.magic, string::POOL_TRACE_MAGIC );
+		EXPECT_EQ( header.version, string::POOL_TRACE_VERSION );
+		EXPECT_EQ( header.recordSize, sizeof( string::PoolTraceRecord ) );
+		ASSERT_EQ( count, 6 );
+
+		// Lease outer, lease inner, return inner, return outer
+		EXPECT_EQ( records[0].event, static_cast<uint8_t>( string::PoolTraceEvent::Lease ) );
+		EXPECT_EQ( records[1].event, static_cast<uint8_t>( string::PoolTraceEvent::Lease ) );
+		EXPECT_EQ( records[2].event, static_cast<uint8_t>( string::PoolTraceEvent::Return ) );
+		EXPECT_EQ( records[3].event, static_cast<uint8_t>( string::PoolTraceEvent::Return ) );
+		EXPECT_EQ( records[2].buffer, records[1].buffer );
+		EXPECT_EQ( records[3].buffer, records[0].buffer );
+		EXPECT_EQ( records[2].size, 300 );
+		EXPECT_EQ( records[3].size, 5 );
+		EXPECT_EQ( records[0].thread, records[3].thread );
+		EXPECT_LE( records[0].timestamp, records[3].timestamp );
+		EXPECT_EQ( records[3].flags, 0 );
+
+		// Async lease released on another thread is flagged as bypassing that thread's cache
+		EXPECT_EQ( records[4].event, static_cast<uint8_t>( string::PoolTraceEvent::Lease ) );
+		EXPECT_EQ( records[5].event, static_cast<uint8_t>( string::PoolTraceEvent::Return ) );
+		EXPECT_EQ( records[5].buffer, records[4].buffer );
+		EXPECT_NE( records[5].thread, records[4].thread );
+		EXPECT_EQ( records[5].flags, string::PoolTraceFlag::SharedPool );
+
+		EXPECT_THROW( string::StringBuilderPool::startTrace( ::testing::TempDir() + "missing/dir/trace.bin" ), std::runtime_error );
+		EXPECT_FALSE( string::StringBuilderPool::isTracing() );
+	}
+
+	TEST( PoolTrace, SimulatorReplayMatchesStats )
+	{
+		const std::string path{ ::testing::TempDir() + "nfx_pool_replay.bin" };
+
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::startTrace( path );
+
+		// One append per lease: each growth jumps straight to max( size, capacity * 1.5 )
+		for ( const size_t size : { 1000, 700, 1800, 3000, 300, 5000 } )
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( size, 'r' );
+		}
+		{
+			auto outer{ string::StringBuilderPool::lease() };
+			outer.create() << std::string( 400, 'o' );
+			auto inner{ string::StringBuilderPool::lease() };
+			inner.create() << std::string( 1500, 'i' );
+		}
+		EXPECT_EQ( string::StringBuilderPool::stopTrace(), 16 );
+		const auto stats{ string::StringBuilderPool::stats() };
+
+		std::FILE* file{ std::fopen( path.c_str(), "rb" ) };
+		ASSERT_NE( file, nullptr );
+		string::PoolTraceHeader header{};
+		std::array<string::PoolTraceRecord, 16> records{};
+		ASSERT_EQ( std::fread( &header, sizeof( header ), 1, file ), 1 );
+		const size_t count{ std::fread( records.data(), sizeof( string::PoolTraceRecord ), records.size(), file ) };
+		std::fclose( file );
+		std::remove( path.c_str() );
+		ASSERT_EQ( count, records.size() );
+
+		// Replayed with the shared pool's own settings
+		string::simulator::PoolModel model{ string::simulator::Configuration{ 256, 2048, 24, false } };
+		for ( const auto& record : records )
+		{
+			model.apply( record );
+		}
+		const auto result{ model.finish() };
+
+		EXPECT_EQ( result.leases, stats.totalRequests );
+		EXPECT_EQ( result.threadLocalHits, stats.threadLocalHits );
+		EXPECT_EQ( result.sharedPoolHits, stats.dynamicStringBufferPoolHits );
+		EXPECT_EQ( result.newBuffers, stats.newAllocations );
+		EXPECT_EQ( result.heapGrowths, stats.heapGrowths );
+		EXPECT_EQ( result.oversizeDiscards, stats.oversizeDiscards );
+		EXPECT_EQ( result.poolFullDiscards, stats.poolFullDiscards );
+		EXPECT_EQ( result.unmatchedReturns, 0 );
+		EXPECT_EQ( stats.heapGrowths, 7 );
+		EXPECT_EQ( stats.bytesCopiedOnGrowth, 0 ); // Single appends grow empty buffers
+	}
+
+	//----------------------------------------------
+	// Memory usage
+	//----------------------------------------------
+
+	TEST( StringBuilderPoolManagement, MemoryUsage )
+	{
+		string::StringBuilderPool::clear();
+
+		auto usage{ string::StringBuilderPool::memoryUsage() };
+		EXPECT_EQ( usage.sharedPoolBuffers, 0 );
+		EXPECT_EQ( usage.sharedPoolBytes, 0 );
+		EXPECT_EQ( usage.threadLocalBuffers, 0 );
+		EXPECT_EQ( usage.threadLocalBytes, 0 );
+
+		{
+			auto outer{ string::StringBuilderPool::lease() };
+			outer.create() << std::string( 1000, 'o' ); // Heap block, retained (<= 2048)
+			auto inner{ string::StringBuilderPool::lease() };
+			inner.create() << "inline";
+
+			// Leased buffers are not counted
+			EXPECT_EQ( string::StringBuilderPool::memoryUsage().sharedPoolBuffers, 0 );
+		}
+
+		// Inner parked in the thread cache, outer in the shared pool
+		usage = string::StringBuilderPool::memoryUsage();
+		EXPECT_EQ( usage.threadLocalBuffers, 1 );
+		EXPECT_EQ( usage.threadLocalBytes, sizeof( string::DynamicStringBuffer ) );
+		EXPECT_EQ( usage.sharedPoolBuffers, 1 );
+		EXPECT_GE( usage.sharedPoolBytes, sizeof( string::DynamicStringBuffer ) + 1000 );
+
+		// Another thread sees the shared pool but not this thread's cache
+		string::StringBuilderPool::MemoryUsage workerUsage{};
+		std::thread worker{ [&workerUsage]() { workerUsage = string::StringBuilderPool::memoryUsage(); } };
+		worker.join();
+		EXPECT_EQ( workerUsage.sharedPoolBytes, usage.sharedPoolBytes );
+		EXPECT_EQ( workerUsage.threadLocalBuffers, 0 );
+
+		string::StringBuilderPool::clear();
+		EXPECT_EQ( string::StringBuilderPool::memoryUsage().sharedPoolBytes, 0 );
+	}
+
+	//----------------------------------------------
+	// Memory resource
+	//----------------------------------------------
+
+	/** @brief Forwards to the default resource, counting live blocks */
+	class CountingMemoryResource final : public std::pmr::memory_resource
+	{
+	public:
+		size_t liveBlocks = 0;
+		size_t allocations = 0;
+
+	private:
+		void* do_allocate( size_t bytes, size_t alignment ) override
+		{
+			++liveBlocks;
+			++allocations;
+
+			return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+		}
+
+		void do_deallocate( void* p, size_t bytes, size_t alignment ) override
+		{
+			--liveBlocks;
+			std::pmr::new_delete_resource()->deallocate( p, bytes, alignment );
+		}
+
+		bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+	TEST( StringBuilderPoolManagement, MemoryResource )
+	{
+		static CountingMemoryResource resource;
+		string::StringBuilderPool::clear();
+		EXPECT_EQ( string::StringBuilderPool::memoryResource(), nullptr );
+
+		EXPECT_EQ( string::StringBuilderPool::setMemoryResource( &resource ), nullptr );
+		EXPECT_EQ( string::StringBuilderPool::memoryResource(), &resource );
+
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "short";
+			EXPECT_EQ( resource.allocations, 0 ); // Stack buffer
+
+			lease.create() << std::string( 5000, 'r' );
+			EXPECT_EQ( resource.liveBlocks, 1 );
+			EXPECT_EQ( reinterpret_cast<uintptr_t>( lease.buffer().data() ) % 64, 0 );
+
+			// Swapping back while the block is in use: it still returns to its own resource
+			EXPECT_EQ( string::StringBuilderPool::setMemoryResource( nullptr ), &resource );
+			lease.create() << std::string( 10000, 's' );
+			EXPECT_EQ( resource.liveBlocks, 0 );
+		}
+
+		string::StringBuilderPool::setMemoryResource( &resource );
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 1000, 'k' ); // Retained on return
+		}
+		EXPECT_EQ( resource.liveBlocks, 1 );
+
+		string::StringBuilderPool::setMemoryResource( nullptr );
+		string::StringBuilderPool::clear();
+		EXPECT_EQ( resource.liveBlocks, 0 );
+	}
+
+	//----------------------------------------------
+	// Pool snapshot
+	//----------------------------------------------
+
+	TEST( StringBuilderPoolManagement, SnapshotSeesAllThreadCaches )
+	{
+		string::StringBuilderPool::clear();
+
+		constexpr size_t workerCount = 3;
+		std::mutex mutex;
+		std::condition_variable condition;
+		size_t parked = 0;
+		bool release = false;
+		std::vector<std::thread::id> workerIds( workerCount );
+
+		std::vector<std::thread> workers;
+		for ( size_t i = 0; i < workerCount; ++i )
+		{
+			workers.emplace_back( [&, i]() {
+				{
+					auto lease{ string::StringBuilderPool::lease() };
+					lease.create() << std::string( 500 + i * 500, 'w' ); // Heap block, retained (<= 2048)
+				}
+
+				std::unique_lock<std::mutex> lock{ mutex };
+				workerIds[i] = std::this_thread::get_id();
+				++parked;
+				condition.notify_all();
+				condition.wait( lock, [&release]() { return release; } );
+			} );
+		}
+
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			condition.wait( lock, [&parked]() { return parked == workerCount; } );
+		}
+
+		auto snapshot{ string::StringBuilderPool::snapshot() };
+		for ( size_t i = 0; i < workerCount; ++i )
+		{
+			auto it{ std::find_if( snapshot.threadCaches.begin(), snapshot.threadCaches.end(),
+				[&]( const auto& cache ) { return cache.thread == workerIds[i]; } ) };
+			ASSERT_NE( it, snapshot.threadCaches.end() );
+			EXPECT_EQ( it->buffers, 1 );
+			EXPECT_GE( it->capacity, 500 + i * 500 );
+			EXPECT_EQ( it->retainedBytes, sizeof( string::DynamicStringBuffer ) + it->capacity );
+		}
+		EXPECT_GE( snapshot.totalBuffers, workerCount );
+		EXPECT_GE( snapshot.totalRetainedBytes, snapshot.sharedPoolBytes + 3000 );
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			release = true;
+		}
+		condition.notify_all();
+		for ( auto& worker : workers )
+		{
+			worker.join();
+		}
+
+		// Exited threads leave the registry
+		snapshot = string::StringBuilderPool::snapshot();
+		for ( const auto& id : workerIds )
+		{
+			EXPECT_TRUE( std::none_of( snapshot.threadCaches.begin(), snapshot.threadCaches.end(),
+				[&id]( const auto& cache ) { return cache.thread == id; } ) );
+		}
+
+		// This thread's cache is published on park and cleared on take
+		{
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << "parked";
+		}
+		snapshot = string::StringBuilderPool::snapshot();
+		auto self{ std::find_if( snapshot.threadCaches.begin(), snapshot.threadCaches.end(),
+			[]( const auto& cache ) { return cache.thread == std::this_thread::get_id(); } ) };
+		ASSERT_NE( self, snapshot.threadCaches.end() );
+		EXPECT_EQ( self->buffers, 1 );
+
+		auto lease{ string::StringBuilderPool::lease() };
+		snapshot = string::StringBuilderPool::snapshot();
+		self = std::find_if( snapshot.threadCaches.begin(), snapshot.threadCaches.end(),
+			[]( const auto& cache ) { return cache.thread == std::this_thread::get_id(); } );
+		ASSERT_NE( self, snapshot.threadCaches.end() );
+		EXPECT_EQ( self->buffers, 0 );
+		EXPECT_EQ( self->retainedBytes, 0 );
+	}
+
+	TEST( StringBuilderPoolManagement, SnapshotDuringConcurrentGrowth )
+	{
+		string::StringBuilderPool::clear();
+
+		// Workers lease, grow and return their cached buffers while other threads snapshot them;
+		// run under ThreadSanitizer to check that snapshots never touch a buffer being grown
+		constexpr size_t workerCount = 4;
+		constexpr size_t iterations = 2000;
+		std::atomic<size_t> running{ workerCount };
+		std::atomic<size_t> snapshots{ 0 };
+		std::atomic<bool> consistent{ true };
+
+		std::vector<std::thread> threads;
+		for ( size_t i = 0; i < workerCount; ++i )
+		{
+			threads.emplace_back( [&running, i]() {
+				for ( size_t n = 0; n < iterations; ++n )
+				{
+					{
+						// Every lease releases the cached heap block, then grows again
+						auto lease{ string::StringBuilderPool::lease() };
+						lease.buffer().shrinkToFit();
+						auto builder{ lease.create() };
+						const size_t size{ 300 + ( n * 37 + i * 101 ) % 2800 }; // Above 2048 is discarded
+						for ( size_t appended = 0; appended < size; appended += 50 )
+						{
+							builder << std::string_view{ "0123456789012345678901234567890123456789012345678" } << '|';
+						}
+					}
+					std::this_thread::yield(); // Leave the buffer cached for snapshots to see
+				}
+				running.fetch_sub( 1 );
+			} );
+		}
+		for ( size_t i = 0; i < 2; ++i )
+		{
+			threads.emplace_back( [&]() {
+				do
+				{
+					const auto snapshot{ string::StringBuilderPool::snapshot() };
+					for ( const auto& cache : snapshot.threadCaches )
+					{
+						if ( cache.buffers > 1 || ( cache.buffers == 1 ) != ( cache.retainedBytes >= sizeof( string::DynamicStringBuffer ) ) )
+						{
+							consistent.store( false );
+						}
+					}
+					snapshots.fetch_add( 1 );
+				} while ( running.load() != 0 );
+			} );
+		}
+		for ( auto& thread : threads )
+		{
+			thread.join();
+		}
+
+		EXPECT_TRUE( consistent.load() );
+		EXPECT_GT( snapshots.load(), 0 );
+	}
+
+	//----------------------------------------------
+	// Lease tracking
+	//----------------------------------------------
+
+	TEST( LeaseTracking, OutstandingLeasesAndAge )
+	{
+		// Opt-in
+		const bool wasTracking{ string::StringBuilderPool::leaseTracking() };
+		EXPECT_FALSE( wasTracking );
+		string::StringBuilderPool::setLeaseTracking( true );
+		const size_t baseline{ string::StringBuilderPool::outstandingLeaseCount() };
+
+		std::vector<string::StringBuilderLease> hoarded;
+		hoarded.push_back( string::StringBuilderPool::lease() );
+		const uint32_t hoardLine{ std::source_location::current().line() - 1 };
+		hoarded.push_back( string::StringBuilderPool::asyncLease() );
+		EXPECT_EQ( string::StringBuilderPool::outstandingLeaseCount(), baseline + 2 );
+
+		std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+		{
+			auto shortLived{ string::StringBuilderPool::lease() };
+			EXPECT_EQ( string::StringBuilderPool::outstandingLeaseCount(), baseline + 3 );
+
+			// Only the hoarded leases are older than 10 ms, oldest first
+			auto stale{ string::StringBuilderPool::outstandingLeases( 10'000'000 ) };
+			ASSERT_EQ( stale.size(), 2 );
+			EXPECT_NE( stale[0].file.find( "TESTS_StringBuilderPool" ), std::string_view::npos );
+			EXPECT_EQ( stale[0].line, hoardLine );
+			EXPECT_EQ( stale[0].thread, std::this_thread::get_id() );
+			EXPECT_GE( stale[0].ageNanoseconds, 10'000'000 );
+			EXPECT_GE( stale[0].ageNanoseconds, stale[1].ageNanoseconds );
+
+			EXPECT_EQ( string::StringBuilderPool::outstandingLeases().size(), baseline + 3 );
+		}
+		EXPECT_EQ( string::StringBuilderPool::outstandingLeaseCount(), baseline + 2 );
+
+		// Leases recorded before disabling are still removed on return
+		string::StringBuilderPool::setLeaseTracking( false );
+		{
+			auto untracked{ string::StringBuilderPool::lease() };
+			EXPECT_EQ( string::StringBuilderPool::outstandingLeaseCount(), baseline + 2 );
+		}
+		hoarded.clear();
+		EXPECT_EQ( string::StringBuilderPool::outstandingLeaseCount(), baseline );
+
+		string::StringBuilderPool::setLeaseTracking( wasTracking );
+	}
+
+	//----------------------------------------------
+	// Thread exit handoff
+	//----------------------------------------------
+
+	TEST( StringBuilderPoolManagement, ThreadExitHandsCachedBufferToSharedPool )
+	{
+		string::StringBuilderPool::clear();
+		string::StringBuilderPool::resetStats();
+
+		const void* workerBuffer{ nullptr };
+		std::thread worker{ [&workerBuffer]() {
+			auto lease{ string::StringBuilderPool::lease() };
+			lease.create() << std::string( 1000, 'h' ); // Heap block, retained (<= 2048)
+			workerBuffer = &lease.buffer();
+		} };
+		worker.join();
+
+		auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.threadLocalParks, 1 );
+		EXPECT_EQ( stats.sharedPoolParks, 1 );
+		EXPECT_EQ( string::StringBuilderPool::size(), 1 );
+
+		// The next thread reuses the warm buffer and its heap block
+		auto lease{ string::StringBuilderPool::lease() };
+		EXPECT_EQ( &lease.buffer(), workerBuffer );
+		EXPECT_GE( lease.buffer().capacity(), 1000 );
+		EXPECT_EQ( string::StringBuilderPool::stats().newAllocations, 1 );
+	}
+
+	TEST( StringBuilderPoolManagement, ThreadExitRespectsSharedPoolLimit )
+	{
+		string::StringBuilderPool::clear();
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool cached = false;
+		bool release = false;
+
+		std::thread worker{ [&]() {
+			{
+				auto lease{ string::StringBuilderPool::lease() };
+			}
+
+			std::unique_lock<std::mutex> lock{ mutex };
+			cached = true;
+			condition.notify_all();
+			condition.wait( lock, [&release]() { return release; } );
+		} };
+
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			condition.wait( lock, [&cached]() { return cached; } );
+		}
+
+		// Fill this thread's cache and the shared pool (24 buffers)
+		{
+			std::vector<string::StringBuilderLease> leases;
+			for ( size_t i = 0; i < 25; ++i )
+			{
+				leases.push_back( string::StringBuilderPool::lease() );
+			}
+		}
+		ASSERT_EQ( string::StringBuilderPool::size(), 25 );
+		string::StringBuilderPool::resetStats();
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			release = true;
+		}
+		condition.notify_all();
+		worker.join();
+
+		// No room left: the exiting thread's buffer is deleted
+		auto stats{ string::StringBuilderPool::stats() };
+		EXPECT_EQ( stats.sharedPoolParks, 0 );
+		EXPECT_EQ( stats.poolFullDiscards, 1 );
+		EXPECT_EQ( string::StringBuilderPool::size(), 25 );
+
+		string::StringBuilderPool::clear();
+	}
 } // namespace nfx::string::test
@@ -0,0 +1,219 @@
+/**
+ * @file PoolModel.h
+ * @brief Model of the two-tier pool replayed by PoolSimulator
+ * @details Mirrors the lease, return and growth rules of DynamicStringBufferPool and
+ *          DynamicStringBuffer closely enough that a trace replayed with the library's own settings
+ *          reproduces its counters. Header-only so the tests can check the model against stats().
+ *
+ * Model:
+ * - Returns take the releasing thread's cache first, then the shared pool, as returnToPool() does;
+ *   returns flagged PoolTraceFlag::SharedPool (asyncLease() buffers released on another thread)
+ *   go straight to the shared pool, as returnToSharedPool() does
+ * - A buffer too small for its returned content size grows once, to max( size, capacity * 1.5 ),
+ *   as ensureCapacity() does for a lease built by a single append; leases built from many small
+ *   appends grow more often in reality, so growth counts are a lower bound for those
+ * - Memory counts buffer objects plus heap blocks above the inline stack buffer
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <nfx/string/StringBuilderPool.h>
+
+#include "PoolTraceFormat.h"
+
+namespace nfx::string::simulator
+{
+	//=====================================================================
+	// Pool model
+	//=====================================================================
+
+	/** @brief Inline capacity of DynamicStringBuffer */
+	inline constexpr size_t STACK_BUFFER_SIZE = 256;
+
+	/** @brief Heap growth factor of DynamicStringBuffer */
+	inline constexpr double GROWTH_FACTOR = 1.5;
+
+	/** @brief Size of one buffer object */
+	inline constexpr uint64_t BUFFER_OBJECT_SIZE = sizeof( DynamicStringBuffer );
+
+	/** @brief Pool settings under test, mirroring the DynamicStringBufferPool constructor */
+	struct Configuration
+	{
+		size_t initialCapacity;
+		size_t maximumRetainedCapacity;
+		size_t maxPoolSize;
+		bool shrinkOversizedBuffers;
+	};
+
+	/** @brief Counters accumulated over a replay */
+	struct Result
+	{
+		uint64_t leases = 0;
+		uint64_t threadLocalHits = 0;
+		uint64_t sharedPoolHits = 0;
+		uint64_t newBuffers = 0;
+		uint64_t heapAllocations = 0;
+		uint64_t heapGrowths = 0;
+		uint64_t oversizeShrinks = 0;
+		uint64_t oversizeDiscards = 0;
+		uint64_t poolFullDiscards = 0;
+		uint64_t unmatchedReturns = 0;
+		uint64_t peakBytes = 0;
+		uint64_t retainedBytes = 0;
+	};
+
+	/** @brief Simulated pool replaying trace records in order */
+	class PoolModel final
+	{
+	public:
+		explicit PoolModel( const Configuration& configuration )
+			: m_configuration{ configuration }
+		{
+		}
+
+		void apply( const PoolTraceRecord& record )
+		{
+			if ( record.event == static_cast<uint8_t>( PoolTraceEvent::Lease ) )
+			{
+				lease( record );
+			}
+			else if ( record.event == static_cast<uint8_t>( PoolTraceEvent::Return ) )
+			{
+				giveBack( record );
+			}
+		}
+
+		Result finish()
+		{
+			m_result.retainedBytes = 0;
+			for ( const auto capacity : m_threadCaches )
+			{
+				m_result.retainedBytes += capacity ? bufferBytes( capacity ) : 0;
+			}
+			for ( const auto capacity : m_sharedPool )
+			{
+				m_result.retainedBytes += bufferBytes( capacity );
+			}
+
+			return m_result;
+		}
+
+	private:
+		static uint64_t bufferBytes( size_t capacity ) noexcept
+		{
+			return BUFFER_OBJECT_SIZE + ( capacity > STACK_BUFFER_SIZE ? capacity : 0 );
+		}
+
+		size_t& threadCache( uint16_t thread )
+		{
+			if ( thread >= m_threadCaches.size() )
+			{
+				m_threadCaches.resize( size_t{ thread } + 1, 0 );
+			}
+
+			return m_threadCaches[thread];
+		}
+
+		void lease( const PoolTraceRecord& record )
+		{
+			++m_result.leases;
+
+			size_t capacity = 0;
+			auto& cached = threadCache( record.thread );
+			if ( cached )
+			{
+				++m_result.threadLocalHits;
+				capacity = std::exchange( cached, 0 );
+			}
+			else if ( !m_sharedPool.empty() )
+			{
+				++m_result.sharedPoolHits;
+				capacity = m_sharedPool.back();
+				m_sharedPool.pop_back();
+			}
+			else
+			{
+				++m_result.newBuffers;
+				capacity = std::max( STACK_BUFFER_SIZE, m_configuration.initialCapacity );
+				m_result.heapAllocations += capacity > STACK_BUFFER_SIZE ? 1 : 0;
+				addBytes( bufferBytes( capacity ) );
+			}
+
+			m_live[record.buffer] = capacity;
+		}
+
+		void giveBack( const PoolTraceRecord& record )
+		{
+			const auto it = m_live.find( record.buffer );
+			if ( it == m_live.end() )
+			{
+				// Leased before the trace started
+				++m_result.unmatchedReturns;
+				return;
+			}
+			size_t capacity = it->second;
+			m_live.erase( it );
+
+			if ( capacity < record.size )
+			{
+				// Same rule as ensureCapacity(); the new block is allocated before the old one is released
+				const auto grown = std::max<size_t>( record.size, static_cast<size_t>( static_cast<double>( capacity ) * GROWTH_FACTOR ) );
+				addBytes( bufferBytes( grown ) );
+				m_currentBytes -= bufferBytes( capacity );
+				capacity = grown;
+				++m_result.heapGrowths;
+				++m_result.heapAllocations;
+			}
+
+			if ( capacity > m_configuration.maximumRetainedCapacity )
+			{
+				m_currentBytes -= bufferBytes( capacity );
+				if ( !m_configuration.shrinkOversizedBuffers )
+				{
+					++m_result.oversizeDiscards;
+					return;
+				}
+
+				++m_result.oversizeShrinks;
+				capacity = std::max( STACK_BUFFER_SIZE, m_configuration.initialCapacity );
+				m_result.heapAllocations += capacity > STACK_BUFFER_SIZE ? 1 : 0;
+				addBytes( bufferBytes( capacity ) );
+			}
+
+			auto& cached = threadCache( record.thread );
+			if ( !cached && ( record.flags & PoolTraceFlag::SharedPool ) == 0 )
+			{
+				cached = capacity;
+			}
+			else if ( m_sharedPool.size() < m_configuration.maxPoolSize )
+			{
+				m_sharedPool.push_back( capacity );
+			}
+			else
+			{
+				++m_result.poolFullDiscards;
+				m_currentBytes -= bufferBytes( capacity );
+			}
+		}
+
+		void addBytes( uint64_t bytes ) noexcept
+		{
+			m_currentBytes += bytes;
+			m_result.peakBytes = std::max( m_result.peakBytes, m_currentBytes );
+		}
+
+		const Configuration m_configuration;
+		Result m_result;
+		uint64_t m_currentBytes = 0;
+		std::vector<size_t> m_threadCaches;
+		std::vector<size_t> m_sharedPool;
+		std::unordered_map<uint64_t, size_t> m_live;
+	};
+} // namespace nfx::string::simulator
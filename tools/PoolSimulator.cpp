@@ -0,0 +1,213 @@
+/**
+ * @file PoolSimulator.cpp
+ * @brief Replays a recorded pool trace against candidate pool configurations
+ * @details Reads a trace written by StringBuilderPool::startTrace() and simulates the two-tier pool
+ *          (thread-local cache plus bounded shared pool) for every combination of the given
+ *          settings, reporting hit rate, allocations, discards and peak memory.
+ *
+ *          Usage: PoolSimulator <trace> [options]
+ *            --initial=N[,N...]    Initial buffer capacity in bytes (default 256)
+ *            --retained=N[,N...]   Maximum retained capacity in bytes (default 2048)
+ *            --pool-size=N[,N...]  Shared pool size in buffers (default 24)
+ *            --shrink=on|off|both  Shrink oversized buffers instead of discarding them (default off)
+ *
+ *          The replay rules are described in PoolModel.h.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PoolModel.h"
+
+using namespace nfx::string;
+using namespace nfx::string::simulator;
+
+namespace
+{
+	//=====================================================================
+	// Trace loading
+	//=====================================================================
+
+	std::vector<PoolTraceRecord> loadTrace( const std::string& path )
+	{
+		std::FILE* file = std::fopen( path.c_str(), "rb" );
+		if ( !file )
+		{
+			throw std::runtime_error{ "Cannot open trace file: " + path };
+		}
+
+		PoolTraceHeader header{};
+		const bool validHeader = std::fread( &header, sizeof( header ), 1, file ) == 1 &&
+								 header.magic == POOL_TRACE_MAGIC &&
+								 header.version == POOL_TRACE_VERSION &&
+								 header.recordSize == sizeof( PoolTraceRecord );
+		if ( !validHeader )
+		{
+			std::fclose( file );
+			throw std::runtime_error{ "Not a version " + std::to_string( POOL_TRACE_VERSION ) + " pool trace: " + path };
+		}
+
+		std::vector<PoolTraceRecord> records;
+		std::vector<PoolTraceRecord> block( 4096 );
+		size_t read = 0;
+		while ( ( read = std::fread( block.data(), sizeof( PoolTraceRecord ), block.size(), file ) ) > 0 )
+		{
+			records.insert( records.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>( read ) );
+		}
+		std::fclose( file );
+
+		return records;
+	}
+
+	//=====================================================================
+	// Command line
+	//=====================================================================
+
+	struct Options
+	{
+		std::string tracePath;
+		std::vector<size_t> initialCapacities{ 256 };
+		std::vector<size_t> retainedCapacities{ 2048 };
+		std::vector<size_t> poolSizes{ 24 };
+		std::vector<bool> shrinkModes{ false };
+	};
+
+	std::vector<size_t> parseList( std::string_view value )
+	{
+		std::vector<size_t> values;
+		while ( !value.empty() )
+		{
+			const auto comma = value.find( ',' );
+			values.push_back( std::stoull( std::string{ value.substr( 0, comma ) } ) );
+			value = comma == std::string_view::npos ? std::string_view{} : value.substr( comma + 1 );
+		}
+		if ( values.empty() )
+		{
+			throw std::invalid_argument{ "empty value list" };
+		}
+
+		return values;
+	}
+
+	Options parseOptions( int argc, char** argv )
+	{
+		Options options;
+		for ( int i = 1; i < argc; ++i )
+		{
+			const std::string_view argument{ argv[i] };
+			if ( !argument.starts_with( "--" ) )
+			{
+				options.tracePath = argument;
+				continue;
+			}
+
+			const auto equals = argument.find( '=' );
+			const auto key = argument.substr( 0, equals );
+			const auto value = equals == std::string_view::npos ? std::string_view{} : argument.substr( equals + 1 );
+
+			if ( key == "--initial" )
+			{
+				options.initialCapacities = parseList( value );
+			}
+			else if ( key == "--retained" )
+			{
+				options.retainedCapacities = parseList( value );
+			}
+			else if ( key == "--pool-size" )
+			{
+				options.poolSizes = parseList( value );
+			}
+			else if ( key == "--shrink" && ( value == "on" || value == "off" || value == "both" ) )
+			{
+				options.shrinkModes = value == "both" ? std::vector<bool>{ true, false } : std::vector<bool>{ value == "on" };
+			}
+			else
+			{
+				throw std::invalid_argument{ "unknown option: " + std::string{ argument } };
+			}
+		}
+
+		if ( options.tracePath.empty() )
+		{
+			throw std::invalid_argument{ "usage: PoolSimulator <trace> [--initial=N,...] [--retained=N,...] [--pool-size=N,...] [--shrink=on|off|both]" };
+		}
+
+		return options;
+	}
+} // namespace
+
+//=====================================================================
+// Entry point
+//=====================================================================
+
+int main( int argc, char** argv )
+{
+	try
+	{
+		const auto options = parseOptions( argc, argv );
+		const auto records = loadTrace( options.tracePath );
+
+		uint16_t threads = 0;
+		for ( const auto& record : records )
+		{
+			threads = std::max<uint16_t>( threads, static_cast<uint16_t>( record.thread + 1 ) );
+		}
+		const double seconds = records.empty() ? 0.0 : static_cast<double>( records.back().timestamp ) / 1e9;
+		std::printf( "Trace: %zu records, %u thread(s), %.3f s\n\n", records.size(), threads, seconds );
+
+		std::printf( "%9s %9s %6s %6s | %8s %10s %10s %10s %9s %9s %9s %12s %12s\n",
+			"initial", "retained", "pool", "shrink",
+			"hit rate", "new bufs", "heap alloc", "growths", "shrinks", "oversize", "pool-full", "peak bytes", "retained" );
+
+		for ( const auto initialCapacity : options.initialCapacities )
+		{
+			for ( const auto retainedCapacity : options.retainedCapacities )
+			{
+				for ( const auto poolSize : options.poolSizes )
+				{
+					for ( const bool shrink : options.shrinkModes )
+					{
+						PoolModel model{ Configuration{ initialCapacity, retainedCapacity, poolSize, shrink } };
+						for ( const auto& record : records )
+						{
+							model.apply( record );
+						}
+						const auto result = model.finish();
+
+						const double hitRate = result.leases == 0
+												   ? 0.0
+												   : static_cast<double>( result.threadLocalHits + result.sharedPoolHits ) / static_cast<double>( result.leases );
+						std::printf( "%9zu %9zu %6zu %6s | %8.4f %10llu %10llu %10llu %9llu %9llu %9llu %12llu %12llu\n",
+							initialCapacity, retainedCapacity, poolSize, shrink ? "on" : "off", hitRate,
+							static_cast<unsigned long long>( result.newBuffers ),
+							static_cast<unsigned long long>( result.heapAllocations ),
+							static_cast<unsigned long long>( result.heapGrowths ),
+							static_cast<unsigned long long>( result.oversizeShrinks ),
+							static_cast<unsigned long long>( result.oversizeDiscards ),
+							static_cast<unsigned long long>( result.poolFullDiscards ),
+							static_cast<unsigned long long>( result.peakBytes ),
+							static_cast<unsigned long long>( result.retainedBytes ) );
+						if ( result.unmatchedReturns > 0 )
+						{
+							std::printf( "%34s(%llu returns of buffers leased before the trace started were ignored)\n", "",
+								static_cast<unsigned long long>( result.unmatchedReturns ) );
+						}
+					}
+				}
+			}
+		}
+
+		return EXIT_SUCCESS;
+	}
+	catch ( const std::exception& e )
+	{
+		std::fprintf( stderr, "Error: %s\n", e.what() );
+		return EXIT_FAILURE;
+	}
+}